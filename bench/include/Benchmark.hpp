@@ -0,0 +1,214 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Pedro Cuadra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <functional>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+
+#include <util/Stats.hpp>
+
+using namespace cv;
+using namespace std;
+
+class Benchmark {
+public:
+  /** Benchmark case, runs one or more measurements */
+  typedef function<void(Benchmark &)> Case;
+
+  /** Timing summary of a single measurement */
+  struct Result {
+    /** Measurement name */
+    string name;
+    /** Input variant, e.g. the frame resolution */
+    string variant;
+    /** Wall time of each repetition */
+    Stats<double> timing;
+    /** Extra measured values, e.g. a recall */
+    vector<pair<string, double>> metrics;
+
+    Result(string name, string variant)
+        : name(name), variant(variant), timing(name, "s") {}
+  };
+
+  /**
+   * Microbenchmark runner
+   * @param warmup      Untimed runs before the measurement
+   * @param repetitions Timed runs
+   */
+  Benchmark(int warmup, int repetitions);
+
+  /**
+   * Set the resolutions of the synthetic frames
+   * @param resolutions Frame sizes
+   */
+  void setResolutions(const vector<Size> &resolutions);
+
+  /**
+   * Get the resolutions of the synthetic frames
+   * @return frame sizes
+   */
+  const vector<Size> &getResolutions() const;
+
+  /**
+   * Set a real frame pair, used by the pair benchmarks instead of the
+   * synthetic one
+   * @param first  First frame path
+   * @param second Second frame path
+   * @return true if both frames were read
+   */
+  bool setPair(const string &first, const string &second);
+
+  /**
+   * Get the frame pair of a resolution. The real pair, when set, is scaled
+   * to the resolution's area keeping its aspect ratio.
+   * @param size Frames size
+   * @param type CV_8UC1 or CV_8UC3
+   * @param img1 First frame
+   * @param img2 Second frame
+   * @return variant label, the frames size suffixed with /real for the real
+   *         pair
+   */
+  string framePair(Size size, int type, Mat &img1, Mat &img2) const;
+
+  /**
+   * Time a piece of code
+   * @param name    Measurement name
+   * @param variant Input variant
+   * @param body    Code to be timed
+   * @param setup   Untimed code run before every repetition
+   */
+  void run(const string &name, const string &variant, function<void()> body,
+           function<void()> setup = function<void()>());
+
+  /**
+   * Attach an extra value to the last measurement
+   * @param key   Value name
+   * @param value Value
+   */
+  void annotate(const string &key, double value);
+
+  /**
+   * Get the results of all the measurements run so far
+   * @return results
+   */
+  const vector<Result> &getResults() const;
+
+  /**
+   * Write the results as CSV, one row per measurement
+   * @param out Output stream
+   */
+  void writeCsv(ostream &out) const;
+
+  /**
+   * Write the results as a JSON array
+   * @param out Output stream
+   */
+  void writeJson(ostream &out) const;
+
+  /**
+   * Get the label of a frame resolution
+   * @param size Frame size
+   * @return label in the WIDTHxHEIGHT format
+   */
+  static string sizeLabel(Size size);
+
+  /**
+   * Generate a deterministic textured frame
+   *
+   * Random shapes over a gradient give the detectors corners, blobs and
+   * edges to work on, the same seed always yields the same frame.
+   * @param size Frame size
+   * @param type CV_8UC1 or CV_8UC3
+   * @param seed Random generator seed
+   * @return synthetic frame
+   */
+  static Mat syntheticFrame(Size size, int type, uint64 seed = 0x5eed);
+
+  /**
+   * Get the motion between consecutive synthetic frames, a slight rotation
+   * about the center and a shift
+   * @param size Frame size
+   * @return 2x3 affine transform
+   */
+  static Mat syntheticMotion(Size size);
+
+  /**
+   * Generate a synthetic frame and its copy moved by syntheticMotion
+   * @param size Frames size
+   * @param type CV_8UC1 or CV_8UC3
+   * @param img1 First frame
+   * @param img2 Moved frame
+   */
+  static void syntheticPair(Size size, int type, Mat &img1, Mat &img2);
+
+  /**
+   * Register a benchmark case
+   * @param name     Case name
+   * @param function Case function
+   */
+  static void add(const string &name, Case function);
+
+  /**
+   * Get the registered benchmark cases
+   * @return cases in registration order
+   */
+  static vector<pair<string, Case>> &cases();
+
+private:
+  /** Untimed runs */
+  int warmup;
+  /** Timed runs */
+  int repetitions;
+  /** Synthetic frames resolutions */
+  vector<Size> resolutions;
+  /** Real frame pair, full resolution gray scale and color */
+  Mat realPair[2][2];
+  /** Measurements results */
+  vector<Result> results;
+};
+
+/**
+ * Registers a benchmark case at static initialization
+ */
+class BenchmarkRegistrar {
+public:
+  BenchmarkRegistrar(const string &name, Benchmark::Case function) {
+    Benchmark::add(name, function);
+  }
+};
+
+/** Define and register a benchmark case */
+#define BENCHMARK_CASE(name)                                                   \
+  static void name##_bench(Benchmark &bench);                                  \
+  static BenchmarkRegistrar name##_registrar(#name, name##_bench);             \
+  static void name##_bench(Benchmark &bench)
+
+#endif /* BENCHMARK_H */
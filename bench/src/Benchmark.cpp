@@ -0,0 +1,300 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Pedro Cuadra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+#include <Benchmark.hpp>
+
+#include <cmath>
+#include <sstream>
+
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+
+#include <util/Timing.hpp>
+
+/**
+ * Microbenchmark runner
+ */
+Benchmark::Benchmark(int warmup, int repetitions) {
+  this->warmup = max(0, warmup);
+  this->repetitions = max(1, repetitions);
+  this->resolutions = {Size(640, 480), Size(1642, 1094), Size(2736, 1824)};
+}
+
+/**
+ * Set the resolutions of the synthetic frames
+ */
+void Benchmark::setResolutions(const vector<Size> &resolutions) {
+  this->resolutions = resolutions;
+}
+
+/**
+ * Get the resolutions of the synthetic frames
+ */
+const vector<Size> &Benchmark::getResolutions() const {
+  return this->resolutions;
+}
+
+/**
+ * Set a real frame pair
+ */
+bool Benchmark::setPair(const string &first, const string &second) {
+  const string paths[] = {first, second};
+
+  for (int i = 0; i < 2; i++) {
+    this->realPair[i][1] = imread(paths[i], IMREAD_COLOR);
+
+    if (this->realPair[i][1].empty()) {
+      return false;
+    }
+
+    cvtColor(this->realPair[i][1], this->realPair[i][0], COLOR_BGR2GRAY);
+  }
+
+  return true;
+}
+
+/**
+ * Get the frame pair of a resolution
+ */
+string Benchmark::framePair(Size size, int type, Mat &img1, Mat &img2) const {
+  int channels = type == CV_8UC1 ? 0 : 1;
+  Mat *outputs[] = {&img1, &img2};
+
+  if (this->realPair[0][0].empty()) {
+    syntheticPair(size, type, img1, img2);
+    return sizeLabel(size);
+  }
+
+  for (int i = 0; i < 2; i++) {
+    const Mat &full = this->realPair[i][channels];
+    double factor = sqrt((double)size.area() / full.size().area());
+
+    resize(full, *outputs[i], Size(), factor, factor, INTER_AREA);
+  }
+
+  return sizeLabel(img1.size()) + "/real";
+}
+
+/**
+ * Time a piece of code
+ */
+void Benchmark::run(const string &name, const string &variant,
+                    function<void()> body, function<void()> setup) {
+  Result result(name, variant);
+  Timing timing;
+
+  for (int i = 0; i < this->warmup; i++) {
+    if (setup) {
+      setup();
+    }
+
+    body();
+  }
+
+  for (int i = 0; i < this->repetitions; i++) {
+    if (setup) {
+      setup();
+    }
+
+    timing.start();
+    body();
+    timing.end();
+
+    result.timing.push_back(timing.getDelta());
+  }
+
+  cerr << name << " [" << variant << "]: " << result.timing.mean() << "s"
+       << endl;
+
+  this->results.push_back(result);
+}
+
+/**
+ * Attach an extra value to the last measurement
+ */
+void Benchmark::annotate(const string &key, double value) {
+  if (this->results.empty()) {
+    return;
+  }
+
+  this->results.back().metrics.push_back(make_pair(key, value));
+  cerr << "  " << key << ": " << value << endl;
+}
+
+/**
+ * Get the results of all the measurements run so far
+ */
+const vector<Benchmark::Result> &Benchmark::getResults() const {
+  return this->results;
+}
+
+/**
+ * Write the results as CSV
+ */
+void Benchmark::writeCsv(ostream &out) const {
+  out << "name,variant,repetitions,mean_s,stddev_s,min_s,p50_s,p90_s,p99_s,"
+         "max_s,metrics"
+      << endl;
+
+  for (size_t i = 0; i < this->results.size(); i++) {
+    const Result &r = this->results[i];
+
+    out << r.name << "," << r.variant << "," << r.timing.size() << ","
+        << r.timing.mean() << "," << r.timing.stdDev() << ","
+        << r.timing.minimum() << "," << r.timing.percentile(50) << ","
+        << r.timing.percentile(90) << "," << r.timing.percentile(99) << ","
+        << r.timing.maximum() << ",";
+
+    for (size_t m = 0; m < r.metrics.size(); m++) {
+      out << (m ? ";" : "") << r.metrics[m].first << "="
+          << r.metrics[m].second;
+    }
+
+    out << endl;
+  }
+}
+
+/**
+ * Write the results as a JSON array
+ */
+void Benchmark::writeJson(ostream &out) const {
+  out << "[" << endl;
+
+  for (size_t i = 0; i < this->results.size(); i++) {
+    const Result &r = this->results[i];
+
+    out << "  {\"name\": \"" << r.name << "\", \"variant\": \"" << r.variant
+        << "\", \"repetitions\": " << r.timing.size()
+        << ", \"mean_s\": " << r.timing.mean()
+        << ", \"stddev_s\": " << r.timing.stdDev()
+        << ", \"min_s\": " << r.timing.minimum()
+        << ", \"p50_s\": " << r.timing.percentile(50)
+        << ", \"p90_s\": " << r.timing.percentile(90)
+        << ", \"p99_s\": " << r.timing.percentile(99)
+        << ", \"max_s\": " << r.timing.maximum() << ", \"metrics\": {";
+
+    for (size_t m = 0; m < r.metrics.size(); m++) {
+      out << (m ? ", " : "") << "\"" << r.metrics[m].first
+          << "\": " << r.metrics[m].second;
+    }
+
+    out << "}}" << (i + 1 < this->results.size() ? "," : "") << endl;
+  }
+
+  out << "]" << endl;
+}
+
+/**
+ * Get the label of a frame resolution
+ */
+string Benchmark::sizeLabel(Size size) {
+  ostringstream ss;
+
+  ss << size.width << "x" << size.height;
+
+  return ss.str();
+}
+
+/**
+ * Generate a deterministic textured frame
+ */
+Mat Benchmark::syntheticFrame(Size size, int type, uint64 seed) {
+  RNG rng(seed);
+  Mat frame(size, CV_8UC3);
+  Mat noise(size, CV_16SC3);
+  int shapes = max(1, size.area() / 4000);
+
+  // Horizontal gradient background
+  for (int x = 0; x < size.width; x++) {
+    frame.col(x).setTo(Scalar::all(64 + 128 * x / size.width));
+  }
+
+  for (int i = 0; i < shapes; i++) {
+    Point center(rng.uniform(0, size.width), rng.uniform(0, size.height));
+    Scalar color(rng.uniform(0, 256), rng.uniform(0, 256), rng.uniform(0, 256));
+    int extent = rng.uniform(4, 40);
+
+    switch (rng.uniform(0, 3)) {
+    case 0:
+      circle(frame, center, extent, color, FILLED);
+      break;
+    case 1:
+      rectangle(frame, center, center + Point(extent, extent * 2 / 3), color,
+                FILLED);
+      break;
+    default:
+      line(frame, center,
+           center + Point(rng.uniform(-extent, extent), extent), color, 2);
+      break;
+    }
+  }
+
+  // Sensor-like noise
+  rng.fill(noise, RNG::NORMAL, Scalar::all(0), Scalar::all(4));
+  cv::add(frame, noise, frame, noArray(), CV_8U);
+
+  if (type == CV_8UC1) {
+    cvtColor(frame, frame, COLOR_BGR2GRAY);
+  }
+
+  return frame;
+}
+
+/**
+ * Get the motion between consecutive synthetic frames
+ */
+Mat Benchmark::syntheticMotion(Size size) {
+  Mat motion =
+      getRotationMatrix2D(Point2f(size.width / 2, size.height / 2), 3, 1);
+
+  motion.at<double>(0, 2) += 8;
+  motion.at<double>(1, 2) += 5;
+
+  return motion;
+}
+
+/**
+ * Generate a synthetic frame and its moved copy
+ */
+void Benchmark::syntheticPair(Size size, int type, Mat &img1, Mat &img2) {
+  img1 = syntheticFrame(size, type);
+  warpAffine(img1, img2, syntheticMotion(size), size);
+}
+
+/**
+ * Register a benchmark case
+ */
+void Benchmark::add(const string &name, Case function) {
+  cases().push_back(make_pair(name, function));
+}
+
+/**
+ * Get the registered benchmark cases
+ */
+vector<pair<string, Benchmark::Case>> &Benchmark::cases() {
+  // Function local so registration order across translation units is safe
+  static vector<pair<string, Case>> registered;
+
+  return registered;
+}
@@ -0,0 +1,137 @@
+#include <opencv2/core/core.hpp>
+
+// Detectors define their options in the headers, so they can only be
+// included by a single translation unit
+#include <detectors/AdaptativeThresholdDetect.hpp>
+#include <detectors/CannyDetect.hpp>
+#include <detectors/FastDetect.hpp>
+#include <detectors/FindContourDetect.hpp>
+#include <detectors/HarrisCornerDetect.hpp>
+#include <detectors/HarrisLaplaceDetect.hpp>
+#include <detectors/HoughDetect.hpp>
+#include <detectors/KMeanDetect.hpp>
+#include <detectors/LucidDetect.hpp>
+#include <detectors/MSDDetectorDetect.hpp>
+#include <detectors/OtsuThresholdDetect.hpp>
+#include <detectors/RoadDetect.hpp>
+#include <detectors/SegmentationDetect.hpp>
+#include <detectors/SiftDetect.hpp>
+#include <detectors/SimpleBlobDetect.hpp>
+#include <detectors/StarDetectorDetect.hpp>
+#include <detectors/SurfDetect.hpp>
+#include <detectors/ThresholdDetect.hpp>
+#include <detectors/VggDetect.hpp>
+#include <Benchmark.hpp>
+#include <util/Frame.hpp>
+
+static String keys =
+    "{show           |      | Display images        }"
+    "{all            |      | All Detectors Enable  }" +
+    FeatureDetect::options + AdaptativeThresholdDetect::options +
+    CannyDetect::options + FastDetect::options + FindContourDetect::options +
+    HarrisCornerDetect::options + HarrisLaplaceDetect::options +
+    HoughDetect::options + KMeanDetect::options + LucidDetect::options +
+    MSDDetectorDetect::options + OtsuThresholdDetect::options +
+    RoadDetect::options + SegmentationDetect::options + SiftDetect::options +
+    SimpleBlobDetect::options + StarDetectorDetect::options +
+    SurfDetect::options + ThresholdDetect::options + VggDetect::options;
+
+/**
+ * Time the detection of a single detector on every synthetic resolution
+ * @param bench   Benchmark runner
+ * @param flag    Detector enable flag
+ * @param color   Whether the detector works on color frames
+ * @param maxArea Skip the frames bigger than this, 0 for no limit
+ */
+template <class Detector>
+static void benchDetector(Benchmark &bench, const string &flag, bool color,
+                          int maxArea = 0) {
+  string enable = "-" + flag;
+  const char *argv[] = {"bench_exec", enable.c_str()};
+  CommandLineParser parser(2, argv, keys);
+  Detector detector(parser);
+  Mat image;
+
+  for (size_t i = 0; i < bench.getResolutions().size(); i++) {
+    Size size = bench.getResolutions()[i];
+
+    if (maxArea > 0 && size.area() > maxArea) {
+      continue;
+    }
+
+    image = Benchmark::syntheticFrame(size, color ? CV_8UC3 : CV_8UC1);
+
+    // A new frame per run, so the memoized derived images aren't reused
+    bench.run("detect/" + detector.getName(), Benchmark::sizeLabel(size),
+              [&detector, &image] { detector.detect(makePtr<Frame>(image)); });
+  }
+}
+
+BENCHMARK_CASE(detect_athreshold) {
+  benchDetector<AdaptativeThresholdDetect>(bench, "athreshold", false);
+}
+
+BENCHMARK_CASE(detect_canny) {
+  benchDetector<CannyDetect>(bench, "canny", false);
+}
+
+BENCHMARK_CASE(detect_fast) { benchDetector<FastDetect>(bench, "fast", false); }
+
+BENCHMARK_CASE(detect_findcontour) {
+  benchDetector<FindContourDetect>(bench, "findcontour", false);
+}
+
+BENCHMARK_CASE(detect_harris) {
+  benchDetector<HarrisCornerDetect>(bench, "harris", false);
+}
+
+BENCHMARK_CASE(detect_harrislaplace) {
+  benchDetector<HarrisLaplaceDetect>(bench, "harrislaplace", false);
+}
+
+BENCHMARK_CASE(detect_hough) {
+  benchDetector<HoughDetect>(bench, "hough", false);
+}
+
+BENCHMARK_CASE(detect_kmeans) {
+  // Clustering every pixel doesn't scale, keep it to the small frames
+  benchDetector<KMeanDetect>(bench, "kmeans", true, 640 * 480);
+}
+
+BENCHMARK_CASE(detect_lucid) {
+  benchDetector<LucidDetect>(bench, "lucid", true);
+}
+
+BENCHMARK_CASE(detect_msd) {
+  benchDetector<MSDDetectorDetect>(bench, "msd", false);
+}
+
+BENCHMARK_CASE(detect_otsu) {
+  benchDetector<OtsuThresholdDetect>(bench, "otsu", false);
+}
+
+BENCHMARK_CASE(detect_roaddetect) {
+  benchDetector<RoadDetect>(bench, "roaddetect", false);
+}
+
+BENCHMARK_CASE(detect_segment) {
+  benchDetector<SegmentationDetect>(bench, "segment", false);
+}
+
+BENCHMARK_CASE(detect_sift) { benchDetector<SiftDetect>(bench, "sift", false); }
+
+BENCHMARK_CASE(detect_sblob) {
+  benchDetector<SimpleBlobDetect>(bench, "sblob", false);
+}
+
+BENCHMARK_CASE(detect_star) {
+  benchDetector<StarDetectorDetect>(bench, "star", false);
+}
+
+BENCHMARK_CASE(detect_surf) { benchDetector<SurfDetect>(bench, "surf", false); }
+
+BENCHMARK_CASE(detect_threshold) {
+  benchDetector<ThresholdDetect>(bench, "threshold", false);
+}
+
+BENCHMARK_CASE(detect_vgg) { benchDetector<VggDetect>(bench, "vgg", false); }
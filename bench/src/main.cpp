@@ -0,0 +1,101 @@
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include <opencv2/core/utility.hpp>
+
+#include <Benchmark.hpp>
+#include <util/Log.hpp>
+
+static String keys =
+    "{help h usage ? |                             | Print this message     }"
+    "{warmup         | 2                           | Untimed Runs           }"
+    "{reps           | 10                          | Timed Runs             }"
+    "{filter         |                             | Run Matching Cases     }"
+    "{resolutions    | 640x480,1642x1094,2736x1824 | Synthetic Frame Sizes  }"
+    "{pair           |                             | Real Frame Pair Paths  }"
+    "{format         | csv                         | Output Format csv, json }"
+    "{out            |                             | Output File Path       }";
+
+/**
+ * Parse a comma separated list of WIDTHxHEIGHT sizes
+ * @param list Sizes list
+ * @return parsed sizes
+ */
+static vector<Size> parseResolutions(const string &list) {
+  vector<Size> sizes;
+  stringstream ss(list);
+  string item;
+  Size size;
+  char separator;
+
+  while (getline(ss, item, ',')) {
+    stringstream parser(item);
+
+    if (parser >> size.width >> separator >> size.height && separator == 'x') {
+      sizes.push_back(size);
+    }
+  }
+
+  return sizes;
+}
+
+int main(int argc, char **argv) {
+  CommandLineParser parser(argc, argv, keys);
+  string filter, format;
+  ofstream file;
+
+  if (parser.has("help")) {
+    parser.printMessage();
+    cout << "Cases:" << endl;
+
+    for (size_t i = 0; i < Benchmark::cases().size(); i++) {
+      cout << "  " << Benchmark::cases()[i].first << endl;
+    }
+
+    return 0;
+  }
+
+  Benchmark bench(parser.get<int>("warmup"), parser.get<int>("reps"));
+
+  bench.setResolutions(parseResolutions(parser.get<string>("resolutions")));
+
+  if (parser.has("pair")) {
+    string paths = parser.get<string>("pair");
+    size_t comma = paths.find(',');
+
+    if (comma == string::npos ||
+        !bench.setPair(paths.substr(0, comma), paths.substr(comma + 1))) {
+      cerr << "Can't read the frame pair " << paths << endl;
+      return 1;
+    }
+  }
+
+  filter = parser.has("filter") ? parser.get<string>("filter") : "";
+  format = parser.get<string>("format");
+
+  // Keep the measurements free of console output
+  Log::setLevel(LOG_LEVEL_ERROR);
+
+  for (size_t i = 0; i < Benchmark::cases().size(); i++) {
+    if (Benchmark::cases()[i].first.find(filter) == string::npos) {
+      continue;
+    }
+
+    Benchmark::cases()[i].second(bench);
+  }
+
+  if (parser.has("out")) {
+    file.open(parser.get<string>("out").c_str());
+  }
+
+  ostream &out = file.is_open() ? file : cout;
+
+  if (format == "json") {
+    bench.writeJson(out);
+  } else {
+    bench.writeCsv(out);
+  }
+
+  return 0;
+}
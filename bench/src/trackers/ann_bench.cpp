@@ -0,0 +1,97 @@
+#include <sstream>
+
+#include <opencv2/features2d/features2d.hpp>
+#include <opencv2/xfeatures2d.hpp>
+
+#include <trackers/AnnMatcher.hpp>
+#include <Benchmark.hpp>
+
+/**
+ * Extract the descriptors of a frame pair
+ * @param bench     Benchmark runner
+ * @param detector  Features detector
+ * @param size      Frames size
+ * @param reference Reference frame descriptors
+ * @param query     Moved frame descriptors
+ * @return variant label
+ */
+static string extractPair(const Benchmark &bench, Ptr<Feature2D> detector,
+                          Size size, Mat &reference, Mat &query) {
+  Mat img1, img2;
+  vector<KeyPoint> keyPoints;
+  string label = bench.framePair(size, CV_8UC1, img1, img2);
+
+  detector->detectAndCompute(img1, noArray(), keyPoints, reference);
+  detector->detectAndCompute(img2, noArray(), keyPoints, query);
+
+  return label;
+}
+
+/**
+ * Time the exact and approximate 2-NN searches, and report the recall for
+ * every knob setting
+ * @param bench    Benchmark runner
+ * @param name     Detector name
+ * @param detector Features detector
+ * @param norm     Exact matching norm
+ * @param settings Index knobs to sweep
+ */
+static void benchAnn(Benchmark &bench, const string &name,
+                     Ptr<Feature2D> detector, int norm,
+                     const vector<AnnMatcher::Params> &settings) {
+  BFMatcher exact(norm);
+  vector<vector<DMatch>> exactMatches, approxMatches;
+  Mat reference, query;
+
+  for (size_t i = 0; i < bench.getResolutions().size(); i++) {
+    Size size = bench.getResolutions()[i];
+    string label = extractPair(bench, detector, size, reference, query);
+
+    bench.run("ann_exact/" + name, label,
+              [&exact, &query, &reference, &exactMatches] {
+                exact.knnMatch(query, reference, exactMatches, 2);
+              });
+
+    for (size_t s = 0; s < settings.size(); s++) {
+      AnnMatcher ann(settings[s]);
+      ostringstream variant;
+
+      variant << label << "/trees" << settings[s].trees
+              << "-checks" << settings[s].checks << "-tables"
+              << settings[s].lshTables << "-probe"
+              << settings[s].lshMultiProbe;
+
+      // Built once per reference frame, only the searches are timed
+      bench.run("ann_index/" + name, variant.str(),
+                [&ann, &reference] { ann.setReference(reference); });
+      bench.run("ann_search/" + name, variant.str(),
+                [&ann, &query, &approxMatches] {
+                  ann.knnMatch(query, approxMatches, 2);
+                });
+      bench.annotate("recall_at_1",
+                     AnnMatcher::recall(query, reference, norm, approxMatches,
+                                        exactMatches));
+    }
+  }
+}
+
+BENCHMARK_CASE(ann_surf) {
+  const int checks[] = {16, 64, 256};
+  vector<AnnMatcher::Params> settings(3);
+
+  for (int i = 0; i < 3; i++) {
+    settings[i].checks = checks[i];
+  }
+
+  benchAnn(bench, "SURF", xfeatures2d::SURF::create(400), NORM_L2, settings);
+}
+
+BENCHMARK_CASE(ann_orb) {
+  vector<AnnMatcher::Params> settings(3);
+
+  for (int i = 0; i < 3; i++) {
+    settings[i].lshMultiProbe = i;
+  }
+
+  benchAnn(bench, "ORB", ORB::create(2000), NORM_HAMMING, settings);
+}
@@ -0,0 +1,69 @@
+#include <sstream>
+
+#include <opencv2/imgproc.hpp>
+
+#include <trackers/ParallelFeaturesFinder.hpp>
+#include <Benchmark.hpp>
+
+/**
+ * Check whether two extractions found the same features
+ * @param features  Features per image
+ * @param reference Reference features per image
+ * @return true if keypoints and descriptors are identical
+ */
+static bool sameFeatures(const vector<ImageFeatures> &features,
+                         const vector<ImageFeatures> &reference) {
+  for (size_t i = 0; i < reference.size(); i++) {
+    Mat desc = features[i].descriptors.getMat(ACCESS_READ);
+    Mat refDesc = reference[i].descriptors.getMat(ACCESS_READ);
+
+    if (features[i].keypoints.size() != reference[i].keypoints.size() ||
+        desc.size() != refDesc.size() ||
+        (!desc.empty() && norm(desc, refDesc, NORM_INF) != 0)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+BENCHMARK_CASE(extract_parallel) {
+  const int frames = 8;
+  int maxThreads = max(getNumberOfCPUs(), 2);
+  ParallelFeaturesFinder::FinderFactory factory = [] {
+    return Ptr<FeaturesFinder>(makePtr<SurfFeaturesFinder>());
+  };
+
+  for (size_t r = 0; r < bench.getResolutions().size(); r++) {
+    Size size = bench.getResolutions()[r];
+    vector<Mat> sequence;
+    vector<ImageFeatures> reference(frames), features(frames);
+    double serial = 0;
+
+    for (int f = 0; f < frames; f++) {
+      sequence.push_back(Benchmark::syntheticFrame(size, CV_8UC3, 0x5eed + f));
+    }
+
+    auto read = [&sequence](int i, Mat &image) { image = sequence[i]; };
+
+    ParallelFeaturesFinder(factory, 1)(read, reference);
+
+    for (int threads = 1; threads <= maxThreads; threads++) {
+      ParallelFeaturesFinder extract(factory, threads);
+      ostringstream name;
+
+      name << "extract_images/SURF-" << threads << "T";
+
+      bench.run(name.str(), Benchmark::sizeLabel(size),
+                [&extract, &read, &features] { extract(read, features); },
+                [&features] { features.assign(frames, ImageFeatures()); });
+
+      double median = bench.getResults().back().timing.percentile(50);
+      serial = threads == 1 ? median : serial;
+
+      bench.annotate("threads", threads);
+      bench.annotate("speedup", serial / median);
+      bench.annotate("identical", sameFeatures(features, reference) ? 1 : 0);
+    }
+  }
+}
@@ -0,0 +1,149 @@
+#include <sstream>
+
+#include <opencv2/features2d/features2d.hpp>
+
+#include <trackers/GuidedMatcher.hpp>
+#include <trackers/HammingMatcher.hpp>
+#include <trackers/L2GemmMatcher.hpp>
+#include <Benchmark.hpp>
+
+/**
+ * Time the 2-NN matching of random binary descriptors
+ * @param bench   Benchmark runner
+ * @param name    Matcher name
+ * @param matcher Matcher
+ */
+static void benchBinaryMatcher(Benchmark &bench, const string &name,
+                               Ptr<DescriptorMatcher> matcher) {
+  const int counts[] = {1000, 4000};
+  const int lengths[] = {32, 64};
+  vector<vector<DMatch>> matches;
+  RNG rng(0x5eed);
+
+  for (int c = 0; c < 2; c++) {
+    for (int l = 0; l < 2; l++) {
+      Mat query(counts[c], lengths[l], CV_8U);
+      Mat train(counts[c], lengths[l], CV_8U);
+      ostringstream variant;
+
+      rng.fill(query, RNG::UNIFORM, 0, 256);
+      rng.fill(train, RNG::UNIFORM, 0, 256);
+      variant << counts[c] << "x" << lengths[l] << "B";
+
+      bench.run("match_hamming/" + name, variant.str(),
+                [&matcher, &query, &train, &matches] {
+                  matcher->knnMatch(query, train, matches, 2);
+                });
+    }
+  }
+}
+
+BENCHMARK_CASE(matcher_hamming) {
+  benchBinaryMatcher(bench, "BFMatcher", makePtr<BFMatcher>(NORM_HAMMING));
+  benchBinaryMatcher(bench, "HammingMatcher", makePtr<HammingMatcher>());
+}
+
+BENCHMARK_CASE(matcher_l2) {
+  const int counts[] = {1000, 4000};
+  vector<vector<DMatch>> forward, backward;
+  Ptr<BFMatcher> bf = makePtr<BFMatcher>(NORM_L2);
+  L2GemmMatcher gemm;
+  RNG rng(0x5eed);
+
+  for (int c = 0; c < 2; c++) {
+    // SURF sized descriptors
+    Mat query(counts[c], 64, CV_32F);
+    Mat train(counts[c], 64, CV_32F);
+    ostringstream variant;
+
+    rng.fill(query, RNG::UNIFORM, -1, 1);
+    rng.fill(train, RNG::UNIFORM, -1, 1);
+    variant << counts[c] << "x64f";
+
+    // Ratio test plus cross-check inputs
+    bench.run("match_l2_2way/BFMatcher", variant.str(),
+              [&bf, &query, &train, &forward, &backward] {
+                bf->knnMatch(query, train, forward, 2);
+                bf->knnMatch(train, query, backward, 2);
+              });
+    bench.run("match_l2_2way/L2GemmMatcher", variant.str(),
+              [&gemm, &query, &train, &forward, &backward] {
+                gemm.knnMatch2Way(query, train, forward, backward);
+              });
+  }
+}
+
+/**
+ * Random SURF like features and their translated, noisy, counterpart
+ * @param count     Number of features
+ * @param size      Image size
+ * @param shift     Translation between both images
+ * @param features1 First image features
+ * @param features2 Second image features
+ */
+static void shiftedFeatures(int count, Size size, Point2f shift,
+                            ImageFeatures &features1,
+                            ImageFeatures &features2) {
+  Mat desc1(count, 64, CV_32F), desc2(count, 64, CV_32F);
+  Mat noise(count, 64, CV_32F);
+  RNG rng(0x5eed);
+
+  rng.fill(desc1, RNG::UNIFORM, -1, 1);
+  rng.fill(noise, RNG::NORMAL, 0, 0.05);
+  desc2 = desc1 + noise;
+
+  features1.keypoints.clear();
+  features2.keypoints.clear();
+
+  for (int i = 0; i < count; i++) {
+    Point2f pt(rng.uniform(0.f, (float)size.width),
+               rng.uniform(0.f, (float)size.height));
+
+    features1.keypoints.push_back(KeyPoint(pt, 10));
+    features2.keypoints.push_back(KeyPoint(pt + shift, 10));
+  }
+
+  features1.img_size = size;
+  features2.img_size = size;
+  desc1.copyTo(features1.descriptors);
+  desc2.copyTo(features2.descriptors);
+}
+
+BENCHMARK_CASE(matcher_guided) {
+  const int counts[] = {1000, 4000};
+  const Size size(1094, 1642);
+  const Point2f shift(30, -12);
+  GemmFeaturesMatcher gemm;
+  ImageFeatures features1, features2;
+  MatchesInfo info;
+
+  // Prediction a few pixels off the actual motion
+  Mat predicted = (Mat_<double>(3, 3) << 1, 0, shift.x + 4, 0, 1,
+                   shift.y - 3, 0, 0, 1);
+
+  for (int c = 0; c < 2; c++) {
+    GuidedMatcher guided;
+    ostringstream variant;
+
+    guided.setPrediction(predicted);
+
+    shiftedFeatures(counts[c], size, shift, features1, features2);
+    variant << counts[c] << "x64f";
+
+    bench.run("match_pair/GemmFeaturesMatcher", variant.str(),
+              [&gemm, &features1, &features2, &info] {
+                info = MatchesInfo();
+                gemm(features1, features2, info);
+              });
+    bench.annotate("inliers", info.num_inliers);
+    bench.annotate("comparisons", (double)counts[c] * counts[c]);
+
+    bench.run("match_pair/GuidedMatcher", variant.str(),
+              [&guided, &features1, &features2, &info] {
+                info = MatchesInfo();
+                guided(features1, features2, info);
+              });
+    bench.annotate("inliers", info.num_inliers);
+    bench.annotate("comparisons", guided.getComparisonStats().mean());
+  }
+}
@@ -0,0 +1,63 @@
+#include <opencv2/features2d/features2d.hpp>
+#include <opencv2/xfeatures2d.hpp>
+
+#include <trackers/AnnMatcher.hpp>
+#include <trackers/Int8Matcher.hpp>
+#include <trackers/L2GemmMatcher.hpp>
+#include <Benchmark.hpp>
+#include <util/DescriptorQuantizer.hpp>
+
+BENCHMARK_CASE(matcher_quantized) {
+  Ptr<Feature2D> surf = xfeatures2d::SURF::create(400);
+  Ptr<BFMatcher> bf = makePtr<BFMatcher>(NORM_L2);
+  L2GemmMatcher gemm;
+  vector<vector<DMatch>> reference, matches;
+
+  for (size_t i = 0; i < bench.getResolutions().size(); i++) {
+    Size size = bench.getResolutions()[i];
+    Mat frame1, frame2, desc1, desc2, quantized1, quantized2;
+    vector<KeyPoint> keypoints1, keypoints2;
+    string variant = bench.framePair(size, CV_8UC1, frame1, frame2);
+    float scale = 0;
+
+    surf->detectAndCompute(frame1, noArray(), keypoints1, desc1);
+    surf->detectAndCompute(frame2, noArray(), keypoints2, desc2);
+
+    vector<Mat> descriptors;
+    descriptors.push_back(desc1);
+    descriptors.push_back(desc2);
+    scale = DescriptorQuantizer::fitScale(descriptors);
+    DescriptorQuantizer::quantize(desc1, scale, quantized1);
+    DescriptorQuantizer::quantize(desc2, scale, quantized2);
+
+    Int8Matcher int8(scale);
+
+    bf->knnMatch(desc1, desc2, reference, 2);
+
+    bench.run("match_knn2/BFMatcher", variant,
+              [&bf, &desc1, &desc2, &matches] {
+                bf->knnMatch(desc1, desc2, matches, 2);
+              });
+    bench.annotate("features", desc1.rows);
+    bench.annotate("recall_at_1", AnnMatcher::recall(desc1, desc2, NORM_L2,
+                                                     matches, reference));
+
+    bench.run("match_knn2/L2GemmMatcher", variant,
+              [&gemm, &desc1, &desc2, &matches] {
+                gemm.knnMatch(desc1, desc2, matches, 2);
+              });
+    bench.annotate("features", desc1.rows);
+    bench.annotate("recall_at_1", AnnMatcher::recall(desc1, desc2, NORM_L2,
+                                                     matches, reference));
+
+    // Judged on the float descriptors, quantized distances are approximate
+    bench.run("match_knn2/Int8Matcher", variant,
+              [&int8, &quantized1, &quantized2, &matches] {
+                int8.knnMatch(quantized1, quantized2, matches, 2);
+              });
+    bench.annotate("features", desc1.rows);
+    bench.annotate("recall_at_1", AnnMatcher::recall(desc1, desc2, NORM_L2,
+                                                     matches, reference));
+    bench.annotate("descriptor_bytes", quantized1.cols);
+  }
+}
@@ -0,0 +1,158 @@
+#include <opencv2/features2d/features2d.hpp>
+#include <opencv2/imgproc.hpp>
+#include <opencv2/xfeatures2d.hpp>
+
+#include <trackers/HammingMatcher.hpp>
+#include <trackers/KltTracker.hpp>
+#include <trackers/L2GemmMatcher.hpp>
+#include <trackers/Tracker.hpp>
+#include <Benchmark.hpp>
+
+static String keys = "{show | | Display images }";
+
+/**
+ * Tracker with its stages exposed to be timed separately
+ */
+class StageTracker : public Tracker {
+public:
+  StageTracker(CommandLineParser parser, Ptr<Feature2D> detector,
+               Ptr<DescriptorMatcher> matcher)
+      : Tracker(parser, "Bench", detector, matcher) {}
+
+  void extract(Mat img1, Mat img2) {
+    this->inputImage[0] = img1;
+    this->inputImage[1] = img2;
+    this->frameId[0] = this->frameId[1] = -1;
+    this->extracted[0] = this->extracted[1] = false;
+    this->runExtract();
+  }
+
+  void match() { this->runTrack(); }
+
+  void filter() { this->runFilter(); }
+};
+
+/**
+ * Synthetic frames drifting along the same motion, slightly rotated and
+ * shifted from one frame to the next
+ * @param size     Frames size
+ * @param frames   Number of frames
+ * @param sequence Output frames
+ */
+static void driftingSequence(Size size, int frames, vector<Mat> &sequence) {
+  Mat motion = Benchmark::syntheticMotion(size);
+
+  sequence.assign(1, Benchmark::syntheticFrame(size, CV_8UC1));
+  for (int f = 1; f < frames; f++) {
+    sequence.push_back(Mat());
+    warpAffine(sequence[f - 1], sequence[f], motion, size);
+  }
+}
+
+/**
+ * Time the match and filter stages on every synthetic resolution
+ * @param bench    Benchmark runner
+ * @param name     Detector name
+ * @param detector Features detector
+ * @param matcher  Descriptors matcher
+ */
+static void benchTracker(Benchmark &bench, const string &name,
+                         Ptr<Feature2D> detector,
+                         Ptr<DescriptorMatcher> matcher) {
+  const char *argv[] = {"bench_exec"};
+  CommandLineParser parser(1, argv, keys);
+  StageTracker tracker(parser, detector, matcher);
+  StageTracker pipeline(parser, detector, matcher);
+  vector<Mat> sequence;
+
+  pipeline.addFilter(makePtr<RatioTestFilter>());
+  pipeline.addFilter(makePtr<CrossCheckFilter>());
+  pipeline.addFilter(makePtr<GridMotionFilter>());
+
+  for (size_t i = 0; i < bench.getResolutions().size(); i++) {
+    Size size = bench.getResolutions()[i];
+    string variant = Benchmark::sizeLabel(size);
+
+    driftingSequence(size, 4, sequence);
+
+    // Extraction is covered by the detectors benchmarks
+    tracker.extract(sequence[0], sequence[1]);
+
+    bench.run("track_match/" + name, variant, [&tracker] { tracker.match(); });
+    bench.run("track_filter/" + name, variant, [&tracker] { tracker.filter(); },
+              [&tracker] { tracker.match(); });
+
+    pipeline.extract(sequence[0], sequence[1]);
+    bench.run("track_filter_pipeline/" + name, variant,
+              [&pipeline] { pipeline.filter(); },
+              [&pipeline] { pipeline.match(); });
+
+    for (int sequential = 0; sequential < 2; sequential++) {
+      tracker.setSequential(sequential);
+      bench.run(string(sequential ? "track_sequential/" : "track_pairs/") +
+                    name,
+                variant, [&tracker, &sequence] {
+                  for (size_t f = 0; f + 1 < sequence.size(); f++) {
+                    tracker.track(sequence[f], f, sequence[f + 1], f + 1);
+                  }
+                });
+    }
+
+    // Next frame extracted while the current pair is matched
+    bench.run("track_pipelined/" + name, variant, [&tracker, &sequence] {
+      size_t next = 0;
+
+      tracker.trackSequence(
+          [&sequence, &next](Mat &frame) {
+            if (next >= sequence.size()) {
+              return false;
+            }
+
+            frame = sequence[next++];
+            return true;
+          },
+          [](int) {});
+    });
+  }
+}
+
+BENCHMARK_CASE(tracker_orb) {
+  benchTracker(bench, "ORB", ORB::create(2000),
+               makePtr<BFMatcher>(NORM_HAMMING));
+}
+
+BENCHMARK_CASE(tracker_orb_hamming) {
+  benchTracker(bench, "ORB-HammingMatcher", ORB::create(2000),
+               makePtr<HammingMatcher>());
+}
+
+BENCHMARK_CASE(tracker_surf) {
+  benchTracker(bench, "SURF", xfeatures2d::SURF::create(400),
+               makePtr<BFMatcher>(NORM_L2));
+}
+
+BENCHMARK_CASE(tracker_surf_gemm) {
+  benchTracker(bench, "SURF-L2GemmMatcher", xfeatures2d::SURF::create(400),
+               makePtr<L2GemmMatcher>());
+}
+
+BENCHMARK_CASE(tracker_klt) {
+  const char *argv[] = {"bench_exec"};
+  CommandLineParser parser(1, argv, keys);
+  KltTracker tracker(parser, "Bench", ORB::create(2000));
+  vector<Mat> sequence;
+
+  for (size_t i = 0; i < bench.getResolutions().size(); i++) {
+    Size size = bench.getResolutions()[i];
+
+    driftingSequence(size, 4, sequence);
+
+    // Detection runs on the first pair, afterwards only when tracks thin out
+    bench.run("track_sequential/KLT-ORB", Benchmark::sizeLabel(size),
+              [&tracker, &sequence] {
+                for (size_t f = 0; f + 1 < sequence.size(); f++) {
+                  tracker.track(sequence[f], f, sequence[f + 1], f + 1);
+                }
+              });
+  }
+}
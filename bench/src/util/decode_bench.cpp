@@ -0,0 +1,35 @@
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+
+#include <Benchmark.hpp>
+#include <util/ReducedDecode.hpp>
+
+BENCHMARK_CASE(decode_scaled) {
+  // senseFly corridor frames, scaled as tracking_demo does
+  const Size fullSize(5472, 3648);
+  const double scales[] = {0.3, 0.2, 0.1};
+  string filename = "decode_bench.jpg";
+  Mat image;
+
+  imwrite(filename, Benchmark::syntheticFrame(fullSize, CV_8UC3));
+
+  for (int s = 0; s < 3; s++) {
+    Size target(fullSize.width * scales[s], fullSize.height * scales[s]);
+    int reduction = ReducedDecode::reductionFor(fullSize, target);
+    string variant = Benchmark::sizeLabel(target);
+
+    bench.run("decode_resize/full", variant, [&filename, &target, &image] {
+      image = imread(filename);
+      resize(image, image, target);
+    });
+    bench.annotate("decoded_bytes", (double)fullSize.area() * 3);
+
+    bench.run("decode_resize/reduced", variant,
+              [&filename, &target, &fullSize, &image] {
+                image = ReducedDecode::read(filename, target, fullSize);
+              });
+    bench.annotate("decoded_bytes",
+                   (double)fullSize.area() * 3 / (reduction * reduction));
+    bench.annotate("reduction", reduction);
+  }
+}
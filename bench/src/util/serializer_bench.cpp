@@ -0,0 +1,70 @@
+#include <sstream>
+
+#include <Benchmark.hpp>
+#include <util/CustomSerializer.hpp>
+
+/** Features per serialized file, one per image of a sequence */
+static const int imagesCount = 10;
+
+/**
+ * Generate deterministic SURF-like image features
+ * @param keyPoints Number of keypoints
+ * @param idx       Image index
+ * @return image features
+ */
+static ImageFeatures syntheticFeatures(int keyPoints, int idx) {
+  RNG rng(idx);
+  ImageFeatures features;
+
+  features.img_idx = idx;
+  features.img_size = Size(1642, 1094);
+
+  for (int i = 0; i < keyPoints; i++) {
+    features.keypoints.push_back(
+        KeyPoint(rng.uniform(0.f, 1642.f), rng.uniform(0.f, 1094.f),
+                 rng.uniform(2.f, 40.f), rng.uniform(0.f, 360.f),
+                 rng.uniform(0.f, 1.f), rng.uniform(0, 4)));
+  }
+
+  Mat descriptors(keyPoints, 64, CV_32F);
+  rng.fill(descriptors, RNG::UNIFORM, Scalar(-1), Scalar(1));
+  descriptors.copyTo(features.descriptors);
+
+  return features;
+}
+
+BENCHMARK_CASE(serializer) {
+  const int keyPointsCounts[] = {500, 2000, 8000};
+
+  for (int k = 0; k < 3; k++) {
+    vector<ImageFeatures> features(imagesCount), readFeatures(imagesCount);
+    vector<ImageFeaturesSerializer> writtenData(imagesCount),
+        readData(imagesCount);
+    ostringstream variant;
+    string buffer;
+
+    for (int i = 0; i < imagesCount; i++) {
+      features[i] = syntheticFeatures(keyPointsCounts[k], i);
+      writtenData[i] = ImageFeaturesSerializer(features[i]);
+      readData[i] = ImageFeaturesSerializer(readFeatures[i]);
+    }
+
+    variant << imagesCount << "x" << keyPointsCounts[k] << "kp";
+
+    // In memory storage, so disk speed doesn't blur the numbers
+    bench.run("serialize_write/features", variant.str(),
+              [&writtenData, &buffer] {
+                FileStorage fs(".yml",
+                               FileStorage::WRITE | FileStorage::MEMORY);
+                fs << "features" << writtenData;
+                buffer = fs.releaseAndGetString();
+              });
+
+    bench.run("serialize_read/features", variant.str(),
+              [&readData, &buffer] {
+                FileStorage fs(buffer, FileStorage::READ | FileStorage::MEMORY);
+                fs["features"] >> readData;
+                fs.release();
+              });
+  }
+}
@@ -53,15 +53,14 @@ protected:
    * Run feature detection algorithm
    */
   virtual void runDetect() {
-    blur(this->inputImage, tmpImage, Size(100, 100));
-    adaptiveThreshold(tmpImage, tmpImage, 255, ADAPTIVE_THRESH_MEAN_C,
-                      THRESH_BINARY, 3, 1);
+    adaptiveThreshold(this->frame->getBlurred(Size(100, 100)), tmpImage, 255,
+                      ADAPTIVE_THRESH_MEAN_C, THRESH_BINARY, 3, 1);
   }
 
   /**
    * Update the output image
    */
-  virtual void updateOutputImage() { this->tmpImage.copyTo(this->outputImage); }
+  virtual void updateOutputImage() { this->outputImage = this->tmpImage; }
 
 private:
   /**
@@ -48,6 +48,9 @@ public:
   CannyDetect(CommandLineParser parser)
       : FeatureDetect(parser, "Canny", "canny") {
     this->low_th = parser.get<int>("canny_low_th");
+    this->ratio = 3;
+    this->blur_size = 14;
+    this->cascade_blur = 1;
   }
 
 protected:
@@ -55,23 +58,23 @@ protected:
    * Run feature detection algorithm
    */
   virtual void runDetect() {
-    this->inputImage.copyTo(this->tmpImage);
+    // The first stage reads straight from the borrowed input
+    Mat source = this->inputImage;
 
     for (int i = 0; i < this->cascade_blur; i++) {
       /// Reduce noise with a kernel 3x3
-      blur(this->tmpImage, this->tmpImage,
-           Size(this->blur_size, this->blur_size));
+      blur(source, this->tmpImage, Size(this->blur_size, this->blur_size));
+      source = this->tmpImage;
     }
 
     /// Canny detector
-    Canny(this->tmpImage, this->tmpImage, this->low_th,
-          this->low_th * this->ratio, 3);
+    Canny(source, this->tmpImage, this->low_th, this->low_th * this->ratio, 3);
   }
 
   /**
    * Update the output image
    */
-  virtual void updateOutputImage() { this->tmpImage.copyTo(this->outputImage); }
+  virtual void updateOutputImage() { this->outputImage = this->tmpImage; }
 
   /**
    * Trackbar on change event callback
@@ -67,7 +67,8 @@ protected:
   virtual void runDetect() {
     fastDetector->setThreshold(fastTh);
     fastDetector->setNonmaxSuppression(nonmax);
-    this->fastDetector->detect(this->inputImage, this->keyPoints);
+    this->detectKeyPoints(this->fastDetector, this->inputImage,
+                          this->keyPoints);
   }
 
   /**
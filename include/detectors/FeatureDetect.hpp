@@ -33,6 +33,7 @@
 #include <opencv2/highgui.hpp>
 #include <opencv2/xfeatures2d.hpp>
 
+#include <util/Frame.hpp>
 #include <util/Stats.hpp>
 #include <util/Timing.hpp>
 
@@ -42,6 +43,9 @@ using namespace std;
 
 class FeatureDetect {
 public:
+  /** Comand line parser options common to all the detectors */
+  static const String options;
+
   /**
    * Feature Detection Wrapper Class
    * @param parser Command line parser
@@ -59,15 +63,33 @@ public:
 
   /**
    * Apply detection algorithm
+   *
+   * The input image is borrowed, not copied. It's shared with the caller and
+   * must not be modified while the detector holds it.
    * @param inputImage Input image
    */
-  void detect(Mat inputImage);
+  void detect(const Mat &inputImage);
 
   /**
    * Compute the descriptors
+   *
+   * The input image is borrowed, not copied. It's shared with the caller and
+   * must not be modified while the detector holds it.
    * @param inputImage Input image
    */
-  void compute(Mat inputImage);
+  void compute(const Mat &inputImage);
+
+  /**
+   * Apply detection algorithm to a shared frame
+   * @param frame Input frame
+   */
+  void detect(Ptr<Frame> frame);
+
+  /**
+   * Compute the descriptors of a shared frame
+   * @param frame Input frame
+   */
+  void compute(Ptr<Frame> frame);
 
   /**
    * Print statistics
@@ -92,6 +114,12 @@ public:
    */
   virtual void writeImage(string path);
 
+  /**
+   * Get the output image, rendered on demand
+   * @return output image
+   */
+  const Mat &getOutputImage();
+
   /**
    * Get feature detection enable state
    */
@@ -105,15 +133,27 @@ public:
 
   /**
    * Get the obtained keypoints
-   * @return a vector containing all the keypoints
+   * @return a reference to the vector containing all the keypoints
    */
-  vector<KeyPoint> getKeyPoints();
+  const vector<KeyPoint> &getKeyPoints() const;
 
   /**
    * Get the obtained descriptors
+   * @return a reference to the obtained descriptors
+   */
+  const Mat &getDescriptors() const;
+
+  /**
+   * Move the obtained keypoints out of the detector
+   * @return a vector containing all the keypoints
+   */
+  vector<KeyPoint> takeKeyPoints();
+
+  /**
+   * Move the obtained descriptors out of the detector
    * @return obtained descriptors
    */
-  Mat getDescriptors();
+  Mat takeDescriptors();
 
 protected:
   /** Detector */
@@ -124,6 +164,8 @@ protected:
   Mat descriptors;
   /** Input Image */
   Mat inputImage;
+  /** Input frame and its memoized representations */
+  Ptr<Frame> frame;
   /** Enable showing of image and GUI */
   bool showEnable = false;
   /** Enable state of the detector */
@@ -134,12 +176,31 @@ protected:
   string name;
   /** Output Image */
   Mat outputImage;
+  /** Output image out of date flag */
+  bool outputDirty = true;
   /** Parameters string */
   stringstream paramsString;
   /** Statistics string */
   stringstream statsString;
   /** Keypoints statistics */
   Stats<int> keyPointsStats;
+  /** Number of detection tiles per side, 1 disables tiling */
+  int tiles = 1;
+  /** Overlap between neighbouring tiles in pixels */
+  int tileOverlap = 0;
+  /** Maximum number of keypoints kept per tile, 0 for no limit */
+  int tileBudget = 0;
+
+  /**
+   * Detect keypoints, splitting the image into overlapping tiles processed
+   * in parallel when tiling is enabled. Keypoints found in the overlap bands
+   * are only kept by the tile owning their position.
+   * @param detector  Detector to be used, must allow concurrent detect calls
+   * @param image     Input image
+   * @param keyPoints Detected keypoints in image coordinates
+   */
+  void detectKeyPoints(Ptr<Feature2D> detector, const Mat &image,
+                       vector<KeyPoint> &keyPoints);
 
   /**
    * Re-apply the detection algorithm to the stored input image
@@ -174,6 +235,14 @@ protected:
 private:
   /** Timing stats collector */
   Stats<double> timingStats;
+  /** Input bytes borrowed instead of copied stats collector */
+  Stats<double> borrowedBytesStats;
+
+  /**
+   * Borrow the input frame
+   * @param frame Input frame
+   */
+  void borrowInput(Ptr<Frame> frame);
 
   /**
    * Show the GUI
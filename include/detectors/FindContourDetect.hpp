@@ -58,9 +58,8 @@ protected:
    */
   virtual void runDetect() {
     // Pixels classification
-    blur(this->inputImage, this->tmpImage, Size(100, 100));
-    threshold(this->tmpImage, this->tmpImage, 0, 255,
-              THRESH_BINARY | THRESH_OTSU);
+    // Shared with the frame, findContours doesn't modify its input anymore
+    this->tmpImage = this->frame->getOtsuBinary(Size(100, 100));
 
     // Segmantation
     findContours(this->tmpImage, contours0, hierarchy, RETR_TREE,
@@ -123,7 +122,10 @@ private:
     colorsVec.clear();
 
     for (int idx = 0; idx < contours0.size(); idx++) {
-      colorsVec.push_back(Scalar(rand() & 255, rand() & 255, rand() & 255));
+      // Thread local generator, detectors may run concurrently
+      colorsVec.push_back(Scalar(theRNG().uniform(0, 256),
+                                 theRNG().uniform(0, 256),
+                                 theRNG().uniform(0, 256)));
     }
   }
 };
@@ -91,7 +91,7 @@ protected:
     // namedWindow("Harris - Keypoints", WINDOW_GUI_EXPANDED);
     // imshow("Harris - Keypoints", outputHarrisNormScaled);
 
-    this->tmpImage.copyTo(this->outputImage);
+    this->outputImage = this->tmpImage;
   }
 
 private:
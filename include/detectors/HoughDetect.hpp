@@ -65,6 +65,8 @@ protected:
     Canny(this->tmpImage, this->tmpImage, low_th, low_th * ratio, 3);
 
     HoughLinesP(this->tmpImage, lines, 1, CV_PI / 180, 100, 50, 500);
+
+    keyPointsStats.push_back(lines.size());
   }
 
   /**
@@ -73,8 +75,6 @@ protected:
   virtual void updateOutputImage() {
     cvtColor(this->inputImage, this->outputImage, COLOR_GRAY2BGR);
 
-    keyPointsStats.push_back(lines.size());
-
     for (size_t i = 0; i < lines.size(); i++) {
       Vec4i l = lines[i];
       line(this->outputImage, Point(l[0], l[1]), Point(l[2], l[3]),
@@ -31,7 +31,7 @@
 #include <opencv2/imgproc/imgproc.hpp>
 
 #include <detectors/FeatureDetect.hpp>
-#include <util/Debug.hpp>
+#include <util/Log.hpp>
 
 using namespace cv;
 using namespace cv::xfeatures2d;
@@ -60,9 +60,7 @@ protected:
     Mat samples(count, 3, CV_32F);
     int currSample = 0;
 
-    blur(this->inputImage, this->tmpImage, Size(100, 100));
-
-    this->tmpImage.convertTo(this->tmpImage, CV_32F);
+    this->frame->getBlurred(Size(100, 100)).convertTo(this->tmpImage, CV_32F);
 
     split(this->tmpImage, channeslBgr);
 
@@ -77,18 +75,19 @@ protected:
       }
     }
 
-    TRACE_LINE(__FILE__, __LINE__);
+    LOG_POINT();
 
     kmeans(samples, clusterNum, this->label,
            TermCriteria(TermCriteria::EPS + TermCriteria::COUNT, 10, 1.0), 3,
            KMEANS_PP_CENTERS, centers);
 
-    TRACE_LINE(__FILE__, __LINE__);
+    LOG_POINT();
 
-    this->inputImage.copyTo(this->tmpImage);
+    // Every pixel is overwritten below, no need to copy the input
+    this->tmpImage.create(this->inputImage.size(), this->inputImage.type());
     centers.convertTo(centers, CV_8UC1);
 
-    TRACE_LINE(__FILE__, __LINE__);
+    LOG_POINT();
 
     // Color pixels using labels
     for (int x = 0; x < this->tmpImage.cols; x++) {
@@ -99,13 +98,13 @@ protected:
       }
     }
 
-    TRACE_LINE(__FILE__, __LINE__);
+    LOG_POINT();
   }
 
   /**
    * Update the output image
    */
-  virtual void updateOutputImage() { this->tmpImage.copyTo(this->outputImage); }
+  virtual void updateOutputImage() { this->outputImage = this->tmpImage; }
 
 private:
   /** Temporal Image storage */
@@ -53,15 +53,13 @@ protected:
    * Run feature detection algorithm
    */
   virtual void runDetect() {
-    blur(this->inputImage, this->tmpImage, Size(100, 100));
-    threshold(this->tmpImage, this->tmpImage, 0, 255,
-              THRESH_BINARY | THRESH_OTSU);
+    this->tmpImage = this->frame->getOtsuBinary(Size(100, 100));
   }
 
   /**
    * Update the output image
    */
-  virtual void updateOutputImage() { this->tmpImage.copyTo(this->outputImage); }
+  virtual void updateOutputImage() { this->outputImage = this->tmpImage; }
 
 private:
   /** Temporal Image storage */
@@ -31,7 +31,7 @@
 #include <opencv2/imgproc/imgproc.hpp>
 
 #include <detectors/FeatureDetect.hpp>
-#include <util/Debug.hpp>
+#include <util/Log.hpp>
 
 using namespace cv;
 using namespace cv::xfeatures2d;
@@ -66,13 +66,12 @@ protected:
    * Run feature detection algorithm
    */
   virtual void runDetect() {
-    TRACE_LINE(__FILE__, __LINE__);
+    LOG_POINT();
 
     contours0.clear();
     this->hierarchy.clear();
-    blur(this->inputImage, this->tmpImage, Size(100, 100));
-    threshold(this->tmpImage, this->tmpImage, 0, 255,
-              THRESH_BINARY | THRESH_OTSU);
+    // Shared with the frame, findContours doesn't modify its input anymore
+    this->tmpImage = this->frame->getOtsuBinary(Size(100, 100));
     findContours(this->tmpImage, this->contours0, this->hierarchy, RETR_TREE,
                  CHAIN_APPROX_SIMPLE);
 
@@ -85,13 +84,10 @@ protected:
   virtual void updateOutputImage() {
     RotatedRect ellipse;
     float exentricity;
-    stringstream message;
 
-    TRACE_LINE(__FILE__, __LINE__);
+    LOG_POINT();
 
-    this->inputImage.copyTo(this->outputImage);
-
-    cvtColor(this->outputImage, this->outputImage, CV_GRAY2RGB);
+    cvtColor(this->inputImage, this->outputImage, CV_GRAY2RGB);
 
     for (int idx = 0; idx >= 0; idx = hierarchy[idx][0]) {
       if (this->contours0[idx].size() < 5) {
@@ -109,17 +105,15 @@ protected:
         continue;
       }
 
-      message.str("");
-      message << "Excentricity: " << exentricity;
-
-      Debug::addPoint(__FILE__, __LINE__, message.str());
+      LOG_TRACE(__FILE__ << " (" << __LINE__ << ") - Excentricity: "
+                         << exentricity);
 
       if (getFill()) {
-        TRACE_LINE(__FILE__, __LINE__);
+        LOG_POINT();
         drawContours(this->outputImage, this->contours0, idx, colorsVec[idx],
                      FILLED, 8, hierarchy);
       } else {
-        TRACE_LINE(__FILE__, __LINE__);
+        LOG_POINT();
         drawContours(this->outputImage, this->contours0, idx, colorsVec[idx],
                      10);
       }
@@ -177,7 +171,10 @@ private:
     colorsVec.clear();
 
     for (int idx = 0; idx < contours0.size(); idx++) {
-      colorsVec.push_back(Scalar(rand() & 255, rand() & 255, rand() & 255));
+      // Thread local generator, detectors may run concurrently
+      colorsVec.push_back(Scalar(theRNG().uniform(0, 256),
+                                 theRNG().uniform(0, 256),
+                                 theRNG().uniform(0, 256)));
     }
   }
 };
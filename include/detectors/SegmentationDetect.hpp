@@ -75,9 +75,7 @@ protected:
    * Run feature detection algorithm
    */
   virtual void runDetect() {
-    blur(this->inputImage, this->tmpImage, Size(100, 100));
-    threshold(this->tmpImage, this->tmpImage, 0, 255,
-              THRESH_BINARY | THRESH_OTSU);
+    this->tmpImage = this->frame->getOtsuBinary(Size(100, 100));
     this->detector->detect(this->tmpImage, this->keyPoints);
   }
 
@@ -46,21 +46,23 @@ public:
    * @param parser Comand Line Parser
    */
   ThresholdDetect(CommandLineParser parser)
-      : FeatureDetect(parser, "Threshold", "threshold") {}
+      : FeatureDetect(parser, "Threshold", "threshold") {
+    this->th = 128;
+  }
 
 protected:
   /**
    * Run feature detection algorithm
    */
   virtual void runDetect() {
-    blur(this->inputImage, this->tmpImage, Size(100, 100));
-    threshold(this->tmpImage, this->tmpImage, this->th, 255, THRESH_BINARY);
+    threshold(this->frame->getBlurred(Size(100, 100)), this->tmpImage, this->th,
+              255, THRESH_BINARY);
   }
 
   /**
    * Update the output image
    */
-  virtual void updateOutputImage() { this->tmpImage.copyTo(this->outputImage); }
+  virtual void updateOutputImage() { this->outputImage = this->tmpImage; }
 
   /**
    * Trackbar on change event callback
@@ -0,0 +1,155 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Pedro Cuadra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+#ifndef ANNMATCHER_H
+#define ANNMATCHER_H
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/features2d/features2d.hpp>
+#include <opencv2/flann.hpp>
+
+#include <util/Stats.hpp>
+
+using namespace cv;
+using namespace std;
+
+class AnnMatcher : public DescriptorMatcher {
+public:
+  /** Index and search knobs, trading recall for speed */
+  struct Params {
+    /** Randomized kd-trees, float descriptors */
+    int trees = 4;
+    /** Leaves visited per search, float descriptors */
+    int checks = 64;
+    /** Hash tables, binary descriptors */
+    int lshTables = 6;
+    /** Hash key length in bits, binary descriptors */
+    int lshKeySize = 12;
+    /** Neighbouring buckets probed, binary descriptors */
+    int lshMultiProbe = 1;
+    /** Compare every search against exact matching */
+    bool checkRecall = false;
+  };
+
+  /**
+   * Approximate nearest neighbour matcher. The index over the train
+   * descriptors is built once by train() and reused by every search, with
+   * randomized kd-trees for float descriptors and multi-probe LSH for
+   * binary ones. Masks aren't supported.
+   * @param params Index and search knobs
+   */
+  explicit AnnMatcher(const Params &params = Params());
+
+  virtual bool isMaskSupported() const;
+
+  virtual Ptr<DescriptorMatcher> clone(bool emptyTrainData = false) const;
+
+  virtual void add(InputArrayOfArrays descriptors);
+
+  /**
+   * Build the index over the train descriptors, only once per train set
+   */
+  virtual void train();
+
+  virtual void clear();
+
+  /**
+   * Replace the train descriptors, a reference frame, and build their index
+   * @param reference Train descriptors
+   */
+  void setReference(const Mat &reference);
+
+  /**
+   * Get whether the index is up to date with the train descriptors
+   * @return trained flag
+   */
+  bool isTrained() const;
+
+  /**
+   * Print the build time, search time and recall statistics
+   */
+  void printStats();
+
+  /**
+   * Get the fraction of queries whose nearest match is an exact nearest
+   * neighbour. The match distance is recomputed with the exact norm, so
+   * ties at the nearest distance count as hits and approximate distances,
+   * e.g. of quantized descriptors, don't matter.
+   * @param query    Query descriptors
+   * @param train    Train descriptors the matches index
+   * @param normType Exact matching norm
+   * @param matches  Matches to check per query
+   * @param exact    Exact matches per query
+   * @return recall at 1 in the [0, 1] range
+   */
+  static double recall(const Mat &query, const Mat &train, int normType,
+                       const vector<vector<DMatch>> &matches,
+                       const vector<vector<DMatch>> &exact);
+
+protected:
+  virtual void knnMatchImpl(InputArray queryDescriptors,
+                            vector<vector<DMatch>> &matches, int k,
+                            InputArrayOfArrays masks = noArray(),
+                            bool compactResult = false);
+
+  virtual void radiusMatchImpl(InputArray queryDescriptors,
+                               vector<vector<DMatch>> &matches,
+                               float maxDistance,
+                               InputArrayOfArrays masks = noArray(),
+                               bool compactResult = false);
+
+private:
+  /** Index and search knobs */
+  Params params;
+  /** Indexed descriptors, all the train images stacked */
+  Mat indexed;
+  /** First row of every train image in the indexed descriptors */
+  vector<int> imageStart;
+  /** Search index */
+  Ptr<flann::Index> index;
+  /** Index building time */
+  Stats<double> buildStats;
+  /** Search time */
+  Stats<double> searchStats;
+  /** Recall at 1 against exact matching */
+  Stats<double> recallStats;
+
+  /**
+   * Convert stacked indexed rows into matches
+   * @param indices   Neighbours indices
+   * @param distances Neighbours distances
+   * @param matches   Matches per query
+   */
+  void toMatches(const Mat &indices, const Mat &distances,
+                 vector<vector<DMatch>> &matches) const;
+
+  /**
+   * Check the search results against an exact search
+   * @param query   Query descriptors
+   * @param matches Approximate matches
+   */
+  void checkRecall(const Mat &query, const vector<vector<DMatch>> &matches);
+};
+
+#endif /* ANNMATCHER_H */
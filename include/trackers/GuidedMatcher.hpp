@@ -0,0 +1,97 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Pedro Cuadra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+#ifndef GUIDEDMATCHER_H
+#define GUIDEDMATCHER_H
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/stitching/detail/matchers.hpp>
+
+#include <trackers/HomographyFeaturesMatcher.hpp>
+#include <util/Stats.hpp>
+
+using namespace cv;
+using namespace cv::detail;
+using namespace std;
+
+class GuidedMatcher : public HomographyFeaturesMatcher {
+public:
+  /**
+   * Homography guided pairwise features matcher. The first image keypoints
+   * are projected through a predicted homography and their descriptors are
+   * only compared against the second image keypoints within a radius of the
+   * projection, found through a KeyPointGrid. Without a prediction every
+   * pair of descriptors is compared. L2 distance for float descriptors,
+   * Hamming for binary ones.
+   * @param radius             Search radius around the projections, pixels
+   * @param matchConf          Ratio test confidence, as BestOf2NearestMatcher
+   * @param numMatchesThresh1  Minimum matches to estimate a homography
+   * @param numMatchesThresh2  Minimum inliers to refine the homography
+   */
+  GuidedMatcher(float radius = 40, float matchConf = 0.3f,
+                int numMatchesThresh1 = 6, int numMatchesThresh2 = 6);
+
+  /**
+   * Set the homography predicted for the next pairs
+   * @param H Homography from the first image to the second in pixel
+   *          coordinates, empty to compare every pair of descriptors
+   */
+  void setPrediction(const Mat &H);
+
+  /**
+   * Get the predicted homography
+   * @return homography in pixel coordinates, empty if there's none
+   */
+  const Mat &getPrediction() const;
+
+  /**
+   * Get the descriptor comparisons per matched pair
+   * @return comparisons statistics
+   */
+  const Stats<double> &getComparisonStats() const;
+
+  /**
+   * Print the descriptor comparisons statistics
+   */
+  void printStats();
+
+protected:
+  virtual void match(const ImageFeatures &features1,
+                     const ImageFeatures &features2,
+                     MatchesInfo &matchesInfo);
+
+private:
+  /** Search radius, pixels */
+  float radius;
+  /** Ratio test confidence */
+  float matchConf;
+  /** Predicted homography, pixel coordinates */
+  Mat prediction;
+  /** Descriptor comparisons per pair */
+  Stats<double> comparisonStats;
+  /** Descriptor comparisons over the exhaustive ones per pair */
+  Stats<double> fractionStats;
+};
+
+#endif /* GUIDEDMATCHER_H */
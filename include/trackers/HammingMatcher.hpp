@@ -0,0 +1,75 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Pedro Cuadra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+#ifndef HAMMINGMATCHER_H
+#define HAMMINGMATCHER_H
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/features2d/features2d.hpp>
+
+using namespace cv;
+using namespace std;
+
+class HammingMatcher : public DescriptorMatcher {
+public:
+  /**
+   * Brute-force Hamming matcher for binary descriptors. Queries are matched
+   * in register blocks against cache-sized tiles of the train descriptors,
+   * with the best popcount kernel of the running CPU. 32 and 64 bytes
+   * descriptors have dedicated kernels. Masks aren't supported.
+   */
+  HammingMatcher();
+
+  virtual bool isMaskSupported() const;
+
+  virtual Ptr<DescriptorMatcher> clone(bool emptyTrainData = false) const;
+
+protected:
+  virtual void knnMatchImpl(InputArray queryDescriptors,
+                            vector<vector<DMatch>> &matches, int k,
+                            InputArrayOfArrays masks = noArray(),
+                            bool compactResult = false);
+
+  virtual void radiusMatchImpl(InputArray queryDescriptors,
+                               vector<vector<DMatch>> &matches,
+                               float maxDistance,
+                               InputArrayOfArrays masks = noArray(),
+                               bool compactResult = false);
+
+private:
+  /**
+   * Get the train descriptors of an image
+   * @param imgIdx Train image index
+   * @return train descriptors
+   */
+  Mat getTrain(int imgIdx) const;
+
+  /**
+   * Get the number of train images
+   * @return number of images
+   */
+  int trainCount() const;
+};
+
+#endif /* HAMMINGMATCHER_H */
@@ -0,0 +1,92 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Pedro Cuadra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+#ifndef HOMOGRAPHYFEATURESMATCHER_H
+#define HOMOGRAPHYFEATURESMATCHER_H
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/stitching/detail/matchers.hpp>
+
+using namespace cv;
+using namespace cv::detail;
+using namespace std;
+
+class HomographyFeaturesMatcher : public FeaturesMatcher {
+public:
+  /**
+   * Pairwise features matcher estimating the pair's homography, inliers and
+   * confidence the same way as BestOf2NearestMatcher. Subclasses only have
+   * to find the matches.
+   * @param isThreadSafe       Whether pairs can be matched concurrently
+   * @param numMatchesThresh1  Minimum matches to estimate a homography
+   * @param numMatchesThresh2  Minimum inliers to refine the homography
+   */
+  HomographyFeaturesMatcher(bool isThreadSafe, int numMatchesThresh1,
+                            int numMatchesThresh2);
+
+  /**
+   * Convert a MatchesInfo homography, between image centered coordinates,
+   * into pixel coordinates
+   * @param H     Centered homography from the first image to the second
+   * @param size1 First image size
+   * @param size2 Second image size
+   * @return homography in pixel coordinates, empty if H is empty
+   */
+  static Mat uncentered(const Mat &H, Size size1, Size size2);
+
+protected:
+  /**
+   * Keep the nearest neighbours passing the ratio test, as
+   * BestOf2NearestMatcher does, in either direction or in both
+   * @param forward     Two nearest train descriptors per query
+   * @param backward    Two nearest queries per train descriptor, the train
+   *                    descriptor is the DMatch query
+   * @param matchConf   Ratio test confidence
+   * @param crossCheck  Keep only mutual matches instead of the union of both
+   *                    directions
+   * @param matchesInfo Pair matches
+   */
+  static void ratioTest(const vector<vector<DMatch>> &forward,
+                        const vector<vector<DMatch>> &backward,
+                        float matchConf, bool crossCheck,
+                        MatchesInfo &matchesInfo);
+
+  /**
+   * Estimate the homography from the matches already in matchesInfo and
+   * fill in the inliers mask, inliers count and confidence
+   * @param features1   First image features, the matches queries
+   * @param features2   Second image features, the matches trains
+   * @param matchesInfo Pair matches
+   */
+  void estimateHomography(const ImageFeatures &features1,
+                          const ImageFeatures &features2,
+                          MatchesInfo &matchesInfo) const;
+
+  /** Minimum matches to estimate a homography */
+  int numMatchesThresh1;
+  /** Minimum inliers to refine the homography */
+  int numMatchesThresh2;
+};
+
+#endif /* HOMOGRAPHYFEATURESMATCHER_H */
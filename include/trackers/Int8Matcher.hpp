@@ -0,0 +1,110 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Pedro Cuadra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+#ifndef INT8MATCHER_H
+#define INT8MATCHER_H
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/features2d/features2d.hpp>
+#include <opencv2/stitching/detail/matchers.hpp>
+
+#include <trackers/HomographyFeaturesMatcher.hpp>
+
+using namespace cv;
+using namespace cv::detail;
+using namespace std;
+
+class Int8Matcher : public DescriptorMatcher {
+public:
+  /**
+   * Brute-force L2 matcher for int8 quantized descriptors, see
+   * DescriptorQuantizer. Queries are matched in register blocks against
+   * cache-sized tiles of the train descriptors with integer arithmetic.
+   * 64 and 128 dimensions have dedicated kernels. Masks aren't supported.
+   * @param scale Quantization scale, distances are reported in the float
+   *              descriptors units
+   */
+  explicit Int8Matcher(float scale = 1.f);
+
+  virtual bool isMaskSupported() const;
+
+  virtual Ptr<DescriptorMatcher> clone(bool emptyTrainData = false) const;
+
+protected:
+  virtual void knnMatchImpl(InputArray queryDescriptors,
+                            vector<vector<DMatch>> &matches, int k,
+                            InputArrayOfArrays masks = noArray(),
+                            bool compactResult = false);
+
+  virtual void radiusMatchImpl(InputArray queryDescriptors,
+                               vector<vector<DMatch>> &matches,
+                               float maxDistance,
+                               InputArrayOfArrays masks = noArray(),
+                               bool compactResult = false);
+
+private:
+  /** Quantization scale */
+  float scale;
+
+  /**
+   * Get the train descriptors of an image
+   * @param imgIdx Train image index
+   * @return train descriptors
+   */
+  Mat getTrain(int imgIdx) const;
+
+  /**
+   * Get the number of train images
+   * @return number of images
+   */
+  int trainCount() const;
+};
+
+class Int8FeaturesMatcher : public HomographyFeaturesMatcher {
+public:
+  /**
+   * Pairwise features matcher on top of Int8Matcher, a drop-in for
+   * BestOf2NearestMatcher on quantized descriptors
+   * @param matchConf          Ratio test confidence, as BestOf2NearestMatcher
+   * @param crossCheck         Keep only mutual matches instead of the
+   *                           union of both directions
+   * @param numMatchesThresh1  Minimum matches to estimate a homography
+   * @param numMatchesThresh2  Minimum inliers to refine the homography
+   */
+  Int8FeaturesMatcher(float matchConf = 0.3f, bool crossCheck = false,
+                      int numMatchesThresh1 = 6, int numMatchesThresh2 = 6);
+
+protected:
+  virtual void match(const ImageFeatures &features1,
+                     const ImageFeatures &features2,
+                     MatchesInfo &matchesInfo);
+
+private:
+  /** Ratio test confidence */
+  float matchConf;
+  /** Mutual matches only flag */
+  bool crossCheck;
+};
+
+#endif /* INT8MATCHER_H */
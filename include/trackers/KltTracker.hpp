@@ -0,0 +1,125 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Pedro Cuadra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+#ifndef KLTTRACKER_H
+#define KLTTRACKER_H
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/features2d/features2d.hpp>
+
+#include <trackers/Tracker.hpp>
+#include <util/Frame.hpp>
+#include <util/Stats.hpp>
+
+using namespace cv;
+using namespace std;
+
+class KltTracker : public Tracker {
+public:
+  /** Tracking and re-detection knobs */
+  struct Params {
+    /** Tracks kept after a re-detection */
+    int maxTracks = 2000;
+    /** Re-detect below this many live tracks */
+    int minTracks = 500;
+    /** Re-detect below this fraction of grid cells holding a track */
+    double minCoverage = 0.6;
+    /** Coverage grid cells along the longest image side */
+    int coverageCells = 8;
+    /** Minimum distance between a new keypoint and a live track, pixels */
+    int minDistance = 8;
+    /** Lucas-Kanade search window */
+    Size winSize = Size(21, 21);
+    /** Index of the last pyramid level */
+    int maxLevel = 3;
+    /** Maximum forward-backward tracking error, pixels */
+    float maxFbError = 1.f;
+  };
+
+  /**
+   * Pyramidal Lucas-Kanade tracker. Keypoints of the first image are
+   * tracked into the second one and back, and only kept when they return
+   * close to where they started. The tracked points of a pair are the
+   * starting points of the next one, the detector only runs when the live
+   * tracks are too few or too clustered, or when the first image isn't the
+   * previous second one, matched by frame id. Its gray image and pyramid are
+   * kept for the next pair. No descriptors are computed, the match distance is
+   * the forward-backward error and the matching threshold and filters are
+   * ignored.
+   * @param parser   Command line parser
+   * @param name     Tracker name
+   * @param detector Keypoints detector
+   * @param params   Tracking and re-detection knobs
+   */
+  KltTracker(CommandLineParser parser, string name, Ptr<Feature2D> detector,
+             const Params &params = Params());
+
+  /**
+   * Track every consecutive pair of a sequence of frames. Detection depends
+   * on the live tracks, so the stages always run on the caller's thread.
+   * @param source Frame source
+   * @param sink   Pair consumer
+   * @param depth  Ignored
+   */
+  virtual void trackSequence(FrameSource source, PairSink sink,
+                             size_t depth = 2);
+
+  virtual void printStats();
+
+protected:
+  virtual void runExtract();
+
+  virtual void runTrack();
+
+  virtual void runFilter();
+
+private:
+  /** Tracking and re-detection knobs */
+  Params params;
+  /** Input frames, the second one is kept for the next pair */
+  Ptr<Frame> frames[2];
+  /** Gray scale input images */
+  Mat gray[2];
+  /** Pyramid builds per pair */
+  Stats<int> pyramidBuildStats;
+  /** Pyramids reused from the previous pair */
+  Stats<int> pyramidReuseStats;
+  /** Live tracks per pair */
+  Stats<int> liveStats;
+  /** Keypoints detected per pair, zero when the tracks were enough */
+  Stats<int> detectedStats;
+
+  /**
+   * Check whether the live tracks still cover the first image
+   * @return true if there are enough tracks, spread enough
+   */
+  bool tracksSuffice() const;
+
+  /**
+   * Detect keypoints away from the live tracks until maxTracks
+   */
+  void detectTracks();
+};
+
+#endif /* KLTTRACKER_H */
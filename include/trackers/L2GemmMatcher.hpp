@@ -0,0 +1,120 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Pedro Cuadra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+#ifndef L2GEMMMATCHER_H
+#define L2GEMMMATCHER_H
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/features2d/features2d.hpp>
+#include <opencv2/stitching/detail/matchers.hpp>
+
+#include <trackers/HomographyFeaturesMatcher.hpp>
+
+using namespace cv;
+using namespace cv::detail;
+using namespace std;
+
+class L2GemmMatcher : public DescriptorMatcher {
+public:
+  /**
+   * Brute-force L2 matcher for float descriptors. Distances are expanded as
+   * ||a||² + ||b||² - 2a·b and computed in blocks with a matrix product.
+   * Masks aren't supported.
+   */
+  L2GemmMatcher();
+
+  virtual bool isMaskSupported() const;
+
+  virtual Ptr<DescriptorMatcher> clone(bool emptyTrainData = false) const;
+
+  /**
+   * Find the two nearest neighbours of every query in the train set and of
+   * every train descriptor in the query set, from a single distance
+   * computation. Enough for a ratio test and a cross-check.
+   * @param query    Query descriptors
+   * @param train    Train descriptors
+   * @param forward  Two nearest train descriptors per query
+   * @param backward Two nearest queries per train descriptor, the
+   *                 train descriptor is the DMatch query
+   */
+  void knnMatch2Way(const Mat &query, const Mat &train,
+                    vector<vector<DMatch>> &forward,
+                    vector<vector<DMatch>> &backward) const;
+
+protected:
+  virtual void knnMatchImpl(InputArray queryDescriptors,
+                            vector<vector<DMatch>> &matches, int k,
+                            InputArrayOfArrays masks = noArray(),
+                            bool compactResult = false);
+
+  virtual void radiusMatchImpl(InputArray queryDescriptors,
+                               vector<vector<DMatch>> &matches,
+                               float maxDistance,
+                               InputArrayOfArrays masks = noArray(),
+                               bool compactResult = false);
+
+private:
+  /**
+   * Get the train descriptors of an image
+   * @param imgIdx Train image index
+   * @return train descriptors
+   */
+  Mat getTrain(int imgIdx) const;
+
+  /**
+   * Get the number of train images
+   * @return number of images
+   */
+  int trainCount() const;
+};
+
+class GemmFeaturesMatcher : public HomographyFeaturesMatcher {
+public:
+  /**
+   * Pairwise features matcher on top of L2GemmMatcher, a drop-in for
+   * BestOf2NearestMatcher on float descriptors
+   * @param matchConf          Ratio test confidence, as BestOf2NearestMatcher
+   * @param crossCheck         Keep only mutual matches instead of the
+   *                           union of both directions
+   * @param numMatchesThresh1  Minimum matches to estimate a homography
+   * @param numMatchesThresh2  Minimum inliers to refine the homography
+   */
+  GemmFeaturesMatcher(float matchConf = 0.3f, bool crossCheck = false,
+                      int numMatchesThresh1 = 6, int numMatchesThresh2 = 6);
+
+protected:
+  virtual void match(const ImageFeatures &features1,
+                     const ImageFeatures &features2,
+                     MatchesInfo &matchesInfo);
+
+private:
+  /** Distances matcher */
+  L2GemmMatcher matcher;
+  /** Ratio test confidence */
+  float matchConf;
+  /** Mutual matches only flag */
+  bool crossCheck;
+};
+
+#endif /* L2GEMMMATCHER_H */
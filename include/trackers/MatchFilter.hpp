@@ -0,0 +1,200 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Pedro Cuadra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+#ifndef MATCHFILTER_H
+#define MATCHFILTER_H
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/features2d/features2d.hpp>
+
+#include <util/Stats.hpp>
+
+using namespace cv;
+using namespace std;
+
+/**
+ * Matching state shared by the filters of a pipeline. Image 0 descriptors
+ * are the queries and image 1 descriptors the train set.
+ */
+struct MatchContext {
+  /** Keypoints of both images */
+  const vector<KeyPoint> *keypoints[2];
+  /** Descriptors of both images */
+  const Mat *descriptors[2];
+  /** Size of both images */
+  Size imageSize[2];
+  /**
+   * Nearest neighbours of every query, best first, two when a filter needs
+   * the runner-up and possibly empty otherwise
+   */
+  const vector<vector<DMatch>> *knnMatches;
+  /**
+   * Nearest queries of every train descriptor when the matcher computes
+   * both directions at once, NULL otherwise
+   */
+  const vector<vector<DMatch>> *reverseKnnMatches;
+  /** Matcher used to produce the matches */
+  Ptr<DescriptorMatcher> matcher;
+};
+
+class MatchFilter {
+public:
+  /**
+   * Match filter, a stage of a filtering pipeline
+   * @param name Filter name
+   */
+  explicit MatchFilter(string name);
+
+  virtual ~MatchFilter() {}
+
+  /**
+   * Filter the matches in place, keeping their order
+   * @param context Matching state
+   * @param matches Matches to be filtered
+   */
+  void filter(const MatchContext &context, vector<DMatch> &matches);
+
+  /**
+   * Get the name of the filter
+   * @return filter name
+   */
+  string getName() const;
+
+  /**
+   * Get the nearest neighbours of every query the filter needs
+   * @return number of neighbours, 1 unless the runner-up is compared
+   */
+  virtual int getNeighbours() const;
+
+  /**
+   * Print the cost and survivors statistics
+   */
+  void printStats();
+
+protected:
+  /**
+   * Run the filter
+   * @param context Matching state
+   * @param matches Matches to be filtered
+   */
+  virtual void run(const MatchContext &context, vector<DMatch> &matches) = 0;
+
+private:
+  /** Filter name */
+  string name;
+  /** Filtering time */
+  Stats<double> timingStats;
+  /** Matches kept by the filter */
+  Stats<int> survivorsStats;
+};
+
+class RatioTestFilter : public MatchFilter {
+public:
+  /**
+   * Lowe's ratio test, keeps the matches clearly better than the runner-up
+   * @param ratio Maximum best to second best distance ratio
+   */
+  explicit RatioTestFilter(double ratio = 0.8);
+
+  virtual int getNeighbours() const;
+
+protected:
+  virtual void run(const MatchContext &context, vector<DMatch> &matches);
+
+private:
+  /** Maximum best to second best distance ratio */
+  double ratio;
+};
+
+class CrossCheckFilter : public MatchFilter {
+public:
+  /**
+   * Symmetric cross-check, keeps the matches that are also the best match
+   * of their train descriptor
+   */
+  CrossCheckFilter();
+
+protected:
+  virtual void run(const MatchContext &context, vector<DMatch> &matches);
+
+private:
+  /** Reverse matches, train to query */
+  vector<DMatch> reverse;
+};
+
+class DistanceFilter : public MatchFilter {
+public:
+  /**
+   * Normalized distance threshold
+   * @param threshold Maximum distance, normalized to the [min, max] range of
+   *                  the filtered matches
+   */
+  explicit DistanceFilter(double threshold);
+
+  /**
+   * Set the normalized distance threshold
+   * @param threshold Threshold value
+   */
+  void setThreshold(double threshold);
+
+protected:
+  virtual void run(const MatchContext &context, vector<DMatch> &matches);
+
+private:
+  /** Normalized distance threshold */
+  double threshold;
+};
+
+class GridMotionFilter : public MatchFilter {
+public:
+  /**
+   * Grid-based motion statistics filter. Matches are binned into cell pairs,
+   * a match survives if its cell pair is the dominant one of its query cell
+   * and the neighbouring cells move consistently with it.
+   * @param gridSize Grid cells per side
+   * @param alpha    Support threshold factor
+   */
+  GridMotionFilter(int gridSize = 20, double alpha = 6);
+
+protected:
+  virtual void run(const MatchContext &context, vector<DMatch> &matches);
+
+private:
+  /** Grid cells per side */
+  int gridSize;
+  /** Support threshold factor */
+  double alpha;
+  /** Number of matches per cell pair */
+  vector<int> pairCount;
+
+  /**
+   * Get the cell of a point
+   * @param pt   Point
+   * @param size Image size
+   * @return cell index
+   */
+  int cellOf(Point2f pt, Size size) const;
+};
+
+#endif /* MATCHFILTER_H */
@@ -0,0 +1,99 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Pedro Cuadra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+#ifndef PARALLELFEATURESFINDER_H
+#define PARALLELFEATURESFINDER_H
+
+#include <atomic>
+#include <functional>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/stitching/detail/matchers.hpp>
+
+#include <util/Stats.hpp>
+
+using namespace cv;
+using namespace cv::detail;
+using namespace std;
+
+class ParallelFeaturesFinder {
+public:
+  /** Creates a features finder, one per worker */
+  typedef function<Ptr<FeaturesFinder>()> FinderFactory;
+  /** Reads the image of an index, called from the workers */
+  typedef function<void(int, Mat &)> ImageReader;
+
+  /**
+   * Features extraction of independent images on a pool of workers. Every
+   * worker owns its finder and takes the next pending image, so the
+   * results only depend on the image and match a serial run.
+   * @param factory Features finder factory
+   * @param threads Number of workers, the caller's thread runs them all if
+   *                lower than 2
+   */
+  ParallelFeaturesFinder(FinderFactory factory, int threads);
+
+  /**
+   * Read and extract the features of every image
+   * @param read     Image reader
+   * @param features Features per image, sized to the number of images
+   */
+  void operator()(ImageReader read, vector<ImageFeatures> &features);
+
+  /**
+   * Get the number of workers
+   * @return number of workers
+   */
+  int getThreads() const;
+
+  /**
+   * Print the per image timings
+   */
+  void printStats();
+
+private:
+  /** Features finder factory */
+  FinderFactory factory;
+  /** Number of workers */
+  int threads;
+  /** Image reading time */
+  Stats<double> readStats;
+  /** Features extraction time */
+  Stats<double> extractStats;
+
+  /**
+   * Worker loop, extracts pending images until there are none left
+   * @param read         Image reader
+   * @param next         Next pending image
+   * @param features     Features per image
+   * @param readTimes    Worker reading times
+   * @param extractTimes Worker extraction times
+   */
+  void work(ImageReader read, atomic<int> &next,
+            vector<ImageFeatures> &features, Stats<double> &readTimes,
+            Stats<double> &extractTimes);
+};
+
+#endif /* PARALLELFEATURESFINDER_H */
@@ -0,0 +1,208 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Pedro Cuadra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+#ifndef TILESCAN_H
+#define TILESCAN_H
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/core/utility.hpp>
+
+using namespace cv;
+using namespace std;
+
+/**
+ * Keeps the k nearest train descriptors of every query
+ */
+template <typename D = int> class TopKCollector {
+public:
+  TopKCollector(int queries, int k)
+      : k(k), distances(queries * k, numeric_limits<D>::max()),
+        trainIdx(queries * k, -1), imgIdx(queries * k, -1) {}
+
+  inline void operator()(int q, int img, int t, D d) {
+    D *dist = &this->distances[q * k];
+    int i = k - 1;
+
+    if (d >= dist[i]) {
+      return;
+    }
+
+    // Insertion into the sorted candidates, k is small
+    for (; i > 0 && dist[i - 1] > d; i--) {
+      dist[i] = dist[i - 1];
+      this->trainIdx[q * k + i] = this->trainIdx[q * k + i - 1];
+      this->imgIdx[q * k + i] = this->imgIdx[q * k + i - 1];
+    }
+
+    dist[i] = d;
+    this->trainIdx[q * k + i] = t;
+    this->imgIdx[q * k + i] = img;
+  }
+
+  /**
+   * Get the matches of every query
+   * @param matches  Matches per query, sized to the number of queries
+   * @param distance Maps a collected distance to the DMatch distance
+   */
+  template <class Distance>
+  void getMatches(vector<vector<DMatch>> &matches, Distance distance) const {
+    for (size_t q = 0; q < matches.size(); q++) {
+      matches[q].clear();
+
+      for (int i = 0; i < k && this->trainIdx[q * k + i] >= 0; i++) {
+        matches[q].push_back(DMatch(q, this->trainIdx[q * k + i],
+                                    this->imgIdx[q * k + i],
+                                    distance(this->distances[q * k + i])));
+      }
+    }
+  }
+
+private:
+  int k;
+  vector<D> distances;
+  vector<int> trainIdx;
+  vector<int> imgIdx;
+};
+
+/**
+ * Keeps the train descriptors within an integer distance of every query.
+ * The matches distance is left as the integer one.
+ */
+class RadiusCollector {
+public:
+  RadiusCollector(vector<vector<DMatch>> &matches, int maxDistance)
+      : matches(matches), maxDistance(maxDistance) {}
+
+  inline void operator()(int q, int img, int t, int d) {
+    if (d <= this->maxDistance) {
+      this->matches[q].push_back(DMatch(q, t, img, (float)d));
+    }
+  }
+
+private:
+  vector<vector<DMatch>> &matches;
+  int maxDistance;
+};
+
+/**
+ * Match a range of query blocks against every train tile
+ */
+template <typename T, int Block, class Collector>
+class TileScanBody : public ParallelLoopBody {
+public:
+  /**
+   * Distances between Block queries and a tile of train descriptors
+   * @param queries   Block query descriptors
+   * @param train     First train descriptor of the tile
+   * @param trainStep Bytes between consecutive train descriptors
+   * @param trainRows Number of train descriptors in the tile
+   * @param length    Descriptor length in elements
+   * @param distances Block rows of trainRows distances
+   */
+  typedef void (*Kernel)(const T *const *queries, const T *train,
+                         size_t trainStep, int trainRows, int length,
+                         int *distances);
+
+  /** Train descriptors per tile */
+  static const int trainTile = 256;
+
+  TileScanBody(const Mat &query, const vector<Mat> &train, Kernel kernel,
+               Collector &collect)
+      : query(query), train(train), kernel(kernel), collect(collect) {}
+
+  virtual void operator()(const Range &range) const {
+    vector<int> distances(Block * trainTile);
+    const T *queries[Block];
+
+    for (size_t img = 0; img < this->train.size(); img++) {
+      const Mat &trainDesc = this->train[img];
+
+      // Tiles outside, so a tile stays in cache for all the query blocks
+      for (int t0 = 0; t0 < trainDesc.rows; t0 += trainTile) {
+        int rows = min(trainTile, trainDesc.rows - t0);
+
+        for (int qb = range.start; qb < range.end; qb++) {
+          int q0 = qb * Block;
+          int valid = min(Block, this->query.rows - q0);
+
+          // Short blocks repeat the last query, its extra results are unused
+          for (int b = 0; b < Block; b++) {
+            queries[b] = this->query.ptr<T>(q0 + min(b, valid - 1));
+          }
+
+          this->kernel(queries, trainDesc.ptr<T>(t0), trainDesc.step, rows,
+                       this->query.cols, &distances[0]);
+
+          for (int b = 0; b < valid; b++) {
+            for (int t = 0; t < rows; t++) {
+              this->collect(q0 + b, img, t0 + t, distances[b * rows + t]);
+            }
+          }
+        }
+      }
+    }
+  }
+
+  /**
+   * Run the scan of all the query blocks in parallel
+   * @param query   Query descriptors
+   * @param train   Train descriptors per image, same type and length
+   * @param kernel  Tile kernel
+   * @param collect Distances collector
+   */
+  static void scan(const Mat &query, const vector<Mat> &train, Kernel kernel,
+                   Collector &collect) {
+    int blocks = (query.rows + Block - 1) / Block;
+
+    for (size_t i = 0; i < train.size(); i++) {
+      CV_Assert(train[i].empty() || (train[i].type() == query.type() &&
+                                     train[i].cols == query.cols));
+    }
+
+    parallel_for_(Range(0, blocks),
+                  TileScanBody(query, train, kernel, collect));
+  }
+
+private:
+  const Mat &query;
+  const vector<Mat> &train;
+  Kernel kernel;
+  Collector &collect;
+};
+
+/**
+ * Drop the queries without matches
+ * @param matches Matches per query
+ */
+static inline void compactMatches(vector<vector<DMatch>> &matches) {
+  matches.erase(remove_if(matches.begin(), matches.end(),
+                          [](const vector<DMatch> &m) { return m.empty(); }),
+                matches.end());
+}
+
+#endif /* TILESCAN_H */
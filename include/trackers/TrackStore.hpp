@@ -0,0 +1,177 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Pedro Cuadra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+#ifndef TRACKSTORE_H
+#define TRACKSTORE_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+
+#include <util/Stats.hpp>
+
+using namespace cv;
+using namespace std;
+
+/**
+ * Multi-frame feature tracks with persistent IDs
+ *
+ * Frames are added in order together with their matches against the
+ * previous frame, and every chain of matched keypoints becomes a track.
+ * Observations (frame, keypoint, position) live in struct-of-arrays ring
+ * buffers of fixed capacity, the oldest ones are overwritten, so memory
+ * stays bounded on arbitrarily long sequences. A track dies the first frame
+ * it isn't extended, its slot is recycled on the next frame.
+ */
+class TrackStore {
+public:
+  /**
+   * Constructor
+   * @param capacity Observations kept, rounded up to a power of two
+   */
+  explicit TrackStore(size_t capacity = 1 << 16);
+
+  /**
+   * Add the next frame
+   * @param keypoints Frame keypoints
+   * @param matches   Matches against the previous frame, queries index the
+   *                  previous frame keypoints and trains this one's
+   * @return frame ID, consecutive from 0
+   */
+  int addFrame(const vector<KeyPoint> &keypoints,
+               const vector<DMatch> &matches);
+
+  /**
+   * Get the track of a keypoint of the last frame
+   * @param keypoint Keypoint index
+   * @return track ID, -1 if the keypoint isn't tracked
+   */
+  int64_t trackOf(int keypoint) const;
+
+  /**
+   * Get the tracks extended by the last frame
+   * @param ids Track IDs
+   */
+  void activeTracks(vector<int64_t> &ids) const;
+
+  /**
+   * Get the tracks that died with the last frame
+   * @param ids Track IDs
+   */
+  void retiredTracks(vector<int64_t> &ids) const;
+
+  /**
+   * Get the observations of an active or just retired track still in the
+   * buffers, oldest first
+   * @param id        Track ID
+   * @param frames    Frame IDs
+   * @param keypoints Keypoint indices within their frames, also the
+   *                  descriptor rows
+   * @param points    Keypoint positions
+   * @return false if the track is unknown
+   */
+  bool getTrack(int64_t id, vector<int> &frames, vector<int> &keypoints,
+                vector<Point2f> &points) const;
+
+  /**
+   * Get the number of frames added
+   * @return frames count
+   */
+  int frameCount() const;
+
+  /**
+   * Print the tracks statistics
+   */
+  void printStats();
+
+private:
+  /** Observations ring, one array per field */
+  struct Observations {
+    vector<int> frame;
+    vector<int> keypoint;
+    vector<float> x;
+    vector<float> y;
+    /** Sequence number of the previous observation of the track */
+    vector<int64_t> previous;
+  };
+
+  /** Track slots, one array per field */
+  struct Tracks {
+    vector<int64_t> id;
+    vector<int> firstFrame;
+    vector<int> lastFrame;
+    vector<int> length;
+    /** Sequence number of the last observation */
+    vector<int64_t> lastObservation;
+  };
+
+  /** Observations ring */
+  Observations observations;
+  /** Index mask of the ring */
+  size_t mask;
+  /** Sequence number of the next observation */
+  int64_t nextObservation;
+  /** Track slots */
+  Tracks tracks;
+  /** Slots free for new tracks */
+  vector<int> freeSlots;
+  /** Slots of the tracks extended by the last frame */
+  vector<int> activeSlots;
+  /** Slots of the tracks that died with the last frame */
+  vector<int> retiredSlots;
+  /** Slot of every track ID still known */
+  unordered_map<int64_t, int> slotOf;
+  /** Track slot of every last frame keypoint, -1 if untracked */
+  vector<int> keypointSlot;
+  /** Last frame keypoint positions */
+  vector<Point2f> lastPoints;
+  /** Next track ID */
+  int64_t nextId;
+  /** Frames added */
+  int frames;
+  /** Length of the retired tracks */
+  Stats<int> lengthStats;
+  /** Live tracks per frame */
+  Stats<int> activeStats;
+
+  /**
+   * Start a track at a keypoint of the last frame
+   * @param keypoint Keypoint index
+   * @return track slot
+   */
+  int startTrack(int keypoint);
+
+  /**
+   * Append an observation to a track
+   * @param slot     Track slot
+   * @param frame    Frame ID
+   * @param keypoint Keypoint index
+   * @param point    Keypoint position
+   */
+  void observe(int slot, int frame, int keypoint, Point2f point);
+};
+
+#endif /* TRACKSTORE_H */
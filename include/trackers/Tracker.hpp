@@ -25,11 +25,15 @@
 #ifndef TRACKER_H
 #define TRACKER_H
 
+#include <functional>
+
 #include <opencv2/core/core.hpp>
 #include <opencv2/core/utility.hpp>
 #include <opencv2/xfeatures2d.hpp>
 
 #include <detectors/FeatureDetect.hpp>
+#include <trackers/MatchFilter.hpp>
+#include <util/Stats.hpp>
 
 using namespace cv;
 using namespace cv::xfeatures2d;
@@ -37,6 +41,11 @@ using namespace std;
 
 class Tracker {
 public:
+  /** Frame source, reads the next frame or returns false at the end */
+  typedef function<bool(Mat &)> FrameSource;
+  /** Pair consumer, gets the index of the pair's first frame */
+  typedef function<void(int)> PairSink;
+
   Tracker(CommandLineParser parser, string name, Ptr<Feature2D> detector,
           Ptr<DescriptorMatcher> matcher);
   Tracker(CommandLineParser parser, string name, Ptr<Feature2D> detector);
@@ -45,17 +54,85 @@ public:
   void track(Mat img1, Mat img2);
   void track(Mat img1, Mat img2, int k);
 
+  /**
+   * Track a pair of identified frames. With sequential reuse enabled, the
+   * features of the previous second frame are reused when its id comes
+   * back, as the next first frame or again as the second one. Ids must
+   * change whenever the pixels do, a capture buffer rewritten in place
+   * gets a new id for every frame. Negative ids are never reused.
+   * @param img1 First image
+   * @param id1  First image frame id
+   * @param img2 Second image
+   * @param id2  Second image frame id
+   */
+  void track(Mat img1, int64 id1, Mat img2, int64 id2);
+
+  /**
+   * Track every consecutive pair of a sequence of frames. Frames are read,
+   * extracted and matched in three pipelined stages linked by bounded
+   * queues, so the next frame is read and extracted while the current pair
+   * is matched and filtered. The sink runs on the caller's thread in frame
+   * order, while the tracker holds the pair, so matchesToPoints and
+   * friends give the pair's results. Every frame is extracted through
+   * extractFrame. A source or extraction failure stops the pipeline and is
+   * rethrown here once the stages are joined.
+   * @param source Frame source, called from a reader thread
+   * @param sink   Pair consumer
+   * @param depth  Frames queued between stages, 0 runs every stage on the
+   *               caller's thread
+   */
+  virtual void trackSequence(FrameSource source, PairSink sink,
+                             size_t depth = 2);
+
   void matchesToKeypoints(vector<KeyPoint> &kp1, vector<KeyPoint> &kp2);
   void matchesToPoints(vector<Point2f> &p1, vector<Point2f> &p2);
 
   void setMatchingThreshold(double threshold);
 
+  /**
+   * Reuse the features of the previous second image when it's passed as the
+   * next first image, or again as the second image, a fixed reference.
+   * Only frames tracked with their ids are reused.
+   * @param enable Enable value
+   */
+  void setSequential(bool enable);
+
+  /**
+   * Append a filter to the matches filtering pipeline. Without filters the
+   * matches are filtered by the normalized distance threshold.
+   * @param filter Match filter
+   */
+  void addFilter(Ptr<MatchFilter> filter);
+
   void show();
 
+  virtual void printStats();
+
 protected:
+  Ptr<Feature2D> detector;
   vector<KeyPoint> keypoints[2];
   Mat descriptors[2];
   Mat inputImage[2];
+  /** Frame ids of the input images, negative when unknown */
+  int64 frameId[2];
+  /** Whether the features of an input image are already extracted */
+  bool extracted[2];
+  vector<DMatch> matches;
+  /** Two nearest neighbours of every image 0 descriptor */
+  vector<vector<DMatch>> knnMatches;
+  /** Two nearest neighbours of every image 1 descriptor, when available */
+  vector<vector<DMatch>> reverseKnnMatches;
+
+  /**
+   * Extract the features of a single frame. The pipelined sequence calls it
+   * from its extractor thread while the previous pair is matched, so it
+   * must not touch the pair state.
+   * @param image       Input image
+   * @param keypoints   Output keypoints
+   * @param descriptors Output descriptors
+   */
+  virtual void extractFrame(const Mat &image, vector<KeyPoint> &keypoints,
+                            Mat &descriptors);
 
   virtual void runExtract();
 
@@ -68,13 +145,43 @@ protected:
 private:
   bool showEnable;
   string name;
-  Ptr<Feature2D> detector;
   Ptr<DescriptorMatcher> matcher;
-  vector<DMatch> matches;
+  /** Matcher of the k-NN searches, a plain copy of a cross-checking one */
+  Ptr<DescriptorMatcher> knnMatcher;
+  /** Whether the matcher cross-checks its matches */
+  bool crossCheck;
   Mat outputImage[3];
   double goodTh;
-  double minDist;
-  double maxDist;
+  bool sequential;
+  bool referenceKept;
+  vector<Ptr<MatchFilter>> filters;
+  Ptr<DistanceFilter> distanceFilter;
+  Stats<int> reuseStats;
+
+  /** Pipeline stage statistics */
+  struct StageStats {
+    /** Stage name */
+    string name;
+    /** Seconds spent working per frame */
+    Stats<double> busy;
+    /** Seconds spent blocked on the queues per frame */
+    Stats<double> wait;
+    /** Frames queued at the stage's input when it takes one */
+    Stats<int> queued;
+
+    StageStats(const string &name);
+
+    /**
+     * Print the stage statistics and occupancy, the fraction of the time
+     * spent working
+     */
+    void print();
+  };
+
+  /** Read, extract and match stages statistics */
+  vector<StageStats> stageStats;
+
+  void loadInputs(Mat img1, int64 id1, Mat img2, int64 id2);
 
   void _runExtract();
 
@@ -0,0 +1,181 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Pedro Cuadra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+#ifndef BOUNDEDQUEUE_H
+#define BOUNDEDQUEUE_H
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+using namespace std;
+
+template <typename T> class BoundedQueue {
+public:
+  /**
+   * Blocking producer/consumer queue
+   * @param capacity     Maximum number of queued items
+   * @param costCapacity Maximum summed cost of the queued items, 0 for no
+   *                     limit. A single item is always accepted.
+   */
+  BoundedQueue(size_t capacity, size_t costCapacity = 0) {
+    this->capacity = capacity > 0 ? capacity : 1;
+    this->costCapacity = costCapacity;
+  }
+
+  /**
+   * Queue an item, blocks while the queue is full
+   * @param item New item
+   * @param cost Cost of the item accounted against the cost capacity
+   * @return false if the queue was closed
+   */
+  bool push(T item, size_t cost = 0) {
+    unique_lock<mutex> guard(this->lock);
+
+    this->notFull.wait(guard, [this, cost] {
+      return this->closed || this->fits(cost);
+    });
+
+    if (this->closed) {
+      return false;
+    }
+
+    this->items.push_back(make_pair(item, cost));
+    this->queuedCost += cost;
+    this->notEmpty.notify_one();
+
+    return true;
+  }
+
+  /**
+   * Block until an item of a given cost would fit. With a single producer
+   * the next push of that cost doesn't block, so the item can be produced
+   * after the room is there instead of held while waiting.
+   * @param cost Cost of the next item
+   * @return false if the queue was closed
+   */
+  bool waitForRoom(size_t cost) {
+    unique_lock<mutex> guard(this->lock);
+
+    this->notFull.wait(guard, [this, cost] {
+      return this->closed || this->fits(cost);
+    });
+
+    return !this->closed;
+  }
+
+  /**
+   * Dequeue an item, blocks while the queue is empty
+   * @param item Dequeued item
+   * @return false if the queue is closed and drained
+   */
+  bool pop(T &item) {
+    unique_lock<mutex> guard(this->lock);
+
+    this->notEmpty.wait(
+        guard, [this] { return this->closed || !this->items.empty(); });
+
+    if (this->items.empty()) {
+      return false;
+    }
+
+    item = this->items.front().first;
+    this->queuedCost -= this->items.front().second;
+    this->items.pop_front();
+    this->notFull.notify_all();
+
+    return true;
+  }
+
+  /**
+   * Close the queue, wakes up every blocked producer and consumer. Items
+   * already queued can still be popped.
+   */
+  void close() {
+    unique_lock<mutex> guard(this->lock);
+
+    this->closed = true;
+    this->notFull.notify_all();
+    this->notEmpty.notify_all();
+  }
+
+  /**
+   * Get the number of queued items
+   * @return number of queued items
+   */
+  size_t size() {
+    unique_lock<mutex> guard(this->lock);
+
+    return this->items.size();
+  }
+
+  /**
+   * Get the summed cost of the queued items
+   * @return queued cost
+   */
+  size_t cost() {
+    unique_lock<mutex> guard(this->lock);
+
+    return this->queuedCost;
+  }
+
+private:
+  /** Queued items with their cost */
+  deque<pair<T, size_t>> items;
+  /** Maximum number of queued items */
+  size_t capacity;
+  /** Maximum summed cost of the queued items */
+  size_t costCapacity;
+  /** Summed cost of the queued items */
+  size_t queuedCost = 0;
+  /** Closed queue flag */
+  bool closed = false;
+  /** Queue lock */
+  mutex lock;
+  /** Signaled when an item is dequeued */
+  condition_variable notFull;
+  /** Signaled when an item is queued */
+  condition_variable notEmpty;
+
+  /**
+   * Check if a new item fits in the queue
+   * @param cost Cost of the new item
+   * @return true if it fits
+   */
+  bool fits(size_t cost) {
+    if (this->items.empty()) {
+      return true;
+    }
+
+    if (this->items.size() >= this->capacity) {
+      return false;
+    }
+
+    return this->costCapacity == 0 ||
+           this->queuedCost + cost <= this->costCapacity;
+  }
+};
+
+#endif /* BOUNDEDQUEUE_H */
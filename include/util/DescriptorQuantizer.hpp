@@ -0,0 +1,73 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Pedro Cuadra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+#ifndef DESCRIPTORQUANTIZER_H
+#define DESCRIPTORQUANTIZER_H
+
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+
+using namespace cv;
+using namespace std;
+
+/**
+ * Float descriptors to int8 quantization
+ *
+ * Every component is divided by the same scale and rounded, so distances
+ * between quantized descriptors are the float ones divided by the scale,
+ * up to the rounding error. A single scale keeps the distance a plain
+ * integer sum of squares.
+ */
+class DescriptorQuantizer {
+public:
+  /** Largest quantized magnitude */
+  static const int levels = 127;
+
+  /**
+   * Fit the scale of a set of float descriptors, the largest magnitude
+   * maps to the largest quantized one
+   * @param descriptors Float descriptors of every image sharing the scale
+   * @return scale, 1 if there are no descriptors
+   */
+  static float fitScale(const vector<Mat> &descriptors);
+
+  /**
+   * Quantize float descriptors, out of range components saturate
+   * @param descriptors Float descriptors
+   * @param scale       Scale
+   * @param quantized   CV_8S descriptors
+   */
+  static void quantize(const Mat &descriptors, float scale, Mat &quantized);
+
+  /**
+   * Recover float descriptors from quantized ones
+   * @param quantized   CV_8S descriptors
+   * @param scale       Scale they were quantized with
+   * @param descriptors Float descriptors
+   */
+  static void dequantize(const Mat &quantized, float scale, Mat &descriptors);
+};
+
+#endif /* DESCRIPTORQUANTIZER_H */
@@ -0,0 +1,129 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Pedro Cuadra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+#ifndef FRAME_H
+#define FRAME_H
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <utility>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/core/utility.hpp>
+
+using namespace std;
+using namespace cv;
+
+/**
+ * Per-frame image holder
+ *
+ * Derived representations of the frame are computed lazily the first time
+ * they're requested and memoized, so detectors sharing the same frame only
+ * pay for each derivation once. Share it through a Ptr<Frame>. All getters
+ * are safe to call from concurrent detectors.
+ */
+class Frame {
+public:
+  /**
+   * Constructor
+   * @param image Frame image, borrowed and never modified
+   */
+  explicit Frame(const Mat &image);
+
+  /**
+   * Get the original image
+   * @return original image
+   */
+  const Mat &getImage() const;
+
+  /**
+   * Get the gray scale representation
+   * @return gray scale image
+   */
+  const Mat &getGray();
+
+  /**
+   * Get the box blurred representation of the frame
+   * @param ksize Blur kernel size
+   * @return blurred image
+   */
+  const Mat &getBlurred(Size ksize);
+
+  /**
+   * Get the Otsu binarization of the box blurred frame
+   * @param ksize Blur kernel size
+   * @return binary image
+   */
+  const Mat &getOtsuBinary(Size ksize);
+
+  /**
+   * Get the Lucas-Kanade pyramid of the gray scale representation, as
+   * built by buildOpticalFlowPyramid with its default derivatives and
+   * borders
+   * @param winSize  Lucas-Kanade search window
+   * @param maxLevel Index of the last pyramid level
+   * @return pyramid levels, padded for the window
+   */
+  const vector<Mat> &getFlowPyramid(Size winSize, int maxLevel);
+
+  /**
+   * Get the number of derivations computed so far
+   * @return number of builds
+   */
+  size_t getBuilds() const;
+
+  /**
+   * Get the number of requests served by an already computed derivation,
+   * the builds avoided by sharing the frame
+   * @return number of reuses
+   */
+  size_t getReuses() const;
+
+private:
+  /** Kernel size key */
+  typedef pair<int, int> SizeKey;
+  /** Lucas-Kanade pyramid key, window size and last level */
+  typedef pair<SizeKey, int> FlowKey;
+
+  /** Derivations lock, getters may call each other */
+  recursive_mutex lock;
+
+  /** Original image */
+  Mat image;
+  /** Gray scale image */
+  Mat gray;
+  /** Blurred images by kernel size */
+  map<SizeKey, Mat> blurred;
+  /** Otsu binary images by blur kernel size */
+  map<SizeKey, Mat> otsuBinary;
+  /** Lucas-Kanade pyramids by window size and last level */
+  map<FlowKey, vector<Mat>> flowPyramids;
+  /** Computed derivations */
+  atomic<size_t> builds;
+  /** Requests served by a computed derivation */
+  atomic<size_t> reuses;
+};
+
+#endif /* FRAME_H */
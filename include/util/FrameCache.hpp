@@ -0,0 +1,155 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Pedro Cuadra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+#ifndef FRAMECACHE_H
+#define FRAMECACHE_H
+
+#include <functional>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include <opencv2/core/core.hpp>
+
+using namespace cv;
+using namespace std;
+
+/**
+ * Decoded frames cache
+ *
+ * Frames are keyed by source path, size and imread color flags. The memory
+ * tier keeps the most recently used frames up to a byte budget, so it only
+ * helps when the frames reread between two uses fit in it: an in-order pass
+ * over more frames than the budget holds evicts every frame before it's
+ * read again. The optional disk tier stores every decoded frame as a raw,
+ * uncompressed file, a fixed header followed by the pixels, that later runs
+ * read back without decoding. Disk frames are dropped when the source file
+ * changes. All methods are safe to call from concurrent threads.
+ */
+class FrameCache {
+public:
+  /** Decodes a frame on a cache miss */
+  typedef function<Mat()> Decoder;
+
+  /**
+   * Constructor
+   * @param memoryCap Maximum bytes held by the memory tier, 0 disables it
+   * @param diskDir   Directory of the disk tier, disabled if empty. It must
+   *                  exist.
+   */
+  explicit FrameCache(size_t memoryCap, const string &diskDir = "");
+
+  /**
+   * Get a frame, decoding it on a miss. The returned image shares its
+   * buffer with the cache and must not be modified.
+   * @param path   Source image path
+   * @param size   Frame size
+   * @param flags  imread color flags
+   * @param decode Frame decoder, called when neither tier holds the frame
+   * @return frame, empty if the decoder failed
+   */
+  Mat get(const string &path, Size size, int flags, Decoder decode);
+
+  /**
+   * Get the bytes held by the memory tier
+   * @return bytes
+   */
+  size_t getMemoryBytes();
+
+  /**
+   * Print the hits and misses of every tier
+   */
+  void printStats();
+
+private:
+  /** Frame key */
+  struct Key {
+    string path;
+    int width;
+    int height;
+    int flags;
+
+    bool operator<(const Key &other) const;
+
+    /**
+     * Get a printable representation
+     * @return key string
+     */
+    string str() const;
+  };
+
+  /** Most recently used first */
+  typedef list<pair<Key, Mat>> Entries;
+
+  /** Memory tier byte budget */
+  size_t memoryCap;
+  /** Disk tier directory */
+  string diskDir;
+  /** Memory tier lock */
+  mutex lock;
+  /** Memory tier frames */
+  Entries entries;
+  /** Memory tier index */
+  map<Key, Entries::iterator> index;
+  /** Memory tier bytes */
+  size_t memoryBytes = 0;
+  /** Frames served from memory */
+  size_t memoryHits = 0;
+  /** Frames served from disk */
+  size_t diskHits = 0;
+  /** Decoded frames */
+  size_t misses = 0;
+
+  /**
+   * Insert a frame in the memory tier, evicting the least recently used
+   * @param key   Frame key
+   * @param image Frame
+   */
+  void remember(const Key &key, const Mat &image);
+
+  /**
+   * Get the disk tier file of a frame
+   * @param key Frame key
+   * @return file path
+   */
+  string diskPath(const Key &key) const;
+
+  /**
+   * Read a frame from the disk tier
+   * @param key   Frame key
+   * @param image Frame
+   * @return true if the frame was on disk and up to date
+   */
+  bool readDisk(const Key &key, Mat &image) const;
+
+  /**
+   * Write a frame to the disk tier
+   * @param key   Frame key
+   * @param image Frame
+   */
+  void writeDisk(const Key &key, const Mat &image) const;
+};
+
+#endif /* FRAMECACHE_H */
@@ -31,7 +31,7 @@
 #include <chrono>
 #include <iostream>
 
-#include <util/Debug.hpp>
+#include <util/Log.hpp>
 
 using namespace std;
 using namespace cv;
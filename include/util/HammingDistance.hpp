@@ -0,0 +1,79 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Pedro Cuadra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+#ifndef HAMMINGDISTANCE_H
+#define HAMMINGDISTANCE_H
+
+#include <cstddef>
+#include <stdint.h>
+
+using namespace std;
+
+class HammingDistance {
+public:
+  /** Queries processed together against every train descriptor */
+  static const int queryBlock = 4;
+
+  /** Instruction set of a kernel */
+  enum Isa { SCALAR, AVX2, AVX512 };
+
+  /**
+   * Distances between a block of queries and a tile of train descriptors
+   * @param queries   queryBlock query descriptors
+   * @param train     First train descriptor of the tile
+   * @param trainStep Bytes between consecutive train descriptors
+   * @param trainRows Number of train descriptors in the tile
+   * @param bytes     Descriptor length in bytes
+   * @param distances queryBlock rows of trainRows distances
+   */
+  typedef void (*TileKernel)(const uint8_t *const *queries,
+                             const uint8_t *train, size_t trainStep,
+                             int trainRows, int bytes, int *distances);
+
+  /**
+   * Get the best instruction set supported by the running CPU
+   * @return instruction set
+   */
+  static Isa bestIsa();
+
+  /**
+   * Get the tile kernel for a descriptor length. 32 and 64 bytes have
+   * unrolled kernels, other lengths fall back to a generic scalar one.
+   * @param bytes Descriptor length in bytes
+   * @param isa   Instruction set, must be supported by the running CPU
+   * @return tile kernel
+   */
+  static TileKernel select(int bytes, Isa isa = bestIsa());
+
+  /**
+   * Reference distance between two descriptors
+   * @param a     First descriptor
+   * @param b     Second descriptor
+   * @param bytes Descriptor length in bytes
+   * @return number of different bits
+   */
+  static int distance(const uint8_t *a, const uint8_t *b, int bytes);
+};
+
+#endif /* HAMMINGDISTANCE_H */
@@ -0,0 +1,100 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Pedro Cuadra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+#ifndef IMAGEPREFETCHER_H
+#define IMAGEPREFETCHER_H
+
+#include <thread>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/imgcodecs.hpp>
+
+#include <util/BoundedQueue.hpp>
+
+using namespace std;
+using namespace cv;
+
+class ImagePrefetcher {
+public:
+  /** Decoded image */
+  struct PrefetchedImage {
+    /** Index of the image within the paths list */
+    int idx;
+    /** Decoded image, empty if it couldn't be read */
+    Mat image;
+  };
+
+  /**
+   * Decode images ahead of their consumer in a background thread
+   * @param paths       Paths of the images in reading order
+   * @param depth       Number of images decoded ahead, 0 decodes in the
+   *                    caller's thread
+   * @param memoryCap   Maximum bytes held by the decoded images ahead, the
+   *                    one being decoded included. Frames are expected to
+   *                    be about the same size.
+   * @param flags       imread flags
+   */
+  ImagePrefetcher(vector<string> paths, int depth, size_t memoryCap,
+                  int flags = IMREAD_COLOR);
+
+  /**
+   * Stop decoding and join the decoder thread
+   */
+  ~ImagePrefetcher();
+
+  /**
+   * Get the next image, blocks until it's decoded
+   * @param image Next image
+   * @return false if there are no more images
+   */
+  bool next(PrefetchedImage &image);
+
+private:
+  /** Paths of the images */
+  vector<string> paths;
+  /** imread flags */
+  int flags;
+  /** Next image to be decoded in the caller's thread */
+  int nextIdx = 0;
+  /** Decoded images queue */
+  BoundedQueue<PrefetchedImage> queue;
+  /** Decoder thread */
+  thread decoder;
+  /** Background decoding enable */
+  bool prefetchEnable;
+
+  /**
+   * Decode an image
+   * @param idx Index of the image
+   * @return decoded image
+   */
+  PrefetchedImage decode(int idx);
+
+  /**
+   * Decoder thread loop
+   */
+  void run();
+};
+
+#endif /* IMAGEPREFETCHER_H */
@@ -0,0 +1,81 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Pedro Cuadra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+#ifndef INT8DISTANCE_H
+#define INT8DISTANCE_H
+
+#include <cstddef>
+#include <stdint.h>
+
+using namespace std;
+
+class Int8Distance {
+public:
+  /** Queries processed together against every train descriptor */
+  static const int queryBlock = 4;
+
+  /** Instruction set of a kernel */
+  enum Isa { SCALAR, AVX2 };
+
+  /**
+   * Squared L2 distances between a block of queries and a tile of train
+   * descriptors
+   * @param queries   queryBlock query descriptors
+   * @param train     First train descriptor of the tile
+   * @param trainStep Bytes between consecutive train descriptors
+   * @param trainRows Number of train descriptors in the tile
+   * @param dims      Descriptor length
+   * @param distances queryBlock rows of trainRows distances
+   */
+  typedef void (*TileKernel)(const int8_t *const *queries,
+                             const int8_t *train, size_t trainStep,
+                             int trainRows, int dims, int *distances);
+
+  /**
+   * Get the best instruction set supported by the running CPU
+   * @return instruction set
+   */
+  static Isa bestIsa();
+
+  /**
+   * Get the tile kernel for a descriptor length. 64 and 128 dimensions,
+   * SURF and SIFT, have unrolled kernels, other lengths fall back to a
+   * generic scalar one.
+   * @param dims Descriptor length
+   * @param isa  Instruction set, must be supported by the running CPU
+   * @return tile kernel
+   */
+  static TileKernel select(int dims, Isa isa = bestIsa());
+
+  /**
+   * Reference squared distance between two descriptors
+   * @param a    First descriptor
+   * @param b    Second descriptor
+   * @param dims Descriptor length
+   * @return sum of the squared differences
+   */
+  static int distance(const int8_t *a, const int8_t *b, int dims);
+};
+
+#endif /* INT8DISTANCE_H */
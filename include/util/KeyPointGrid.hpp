@@ -0,0 +1,100 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Pedro Cuadra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+#ifndef KEYPOINT_GRID_H
+#define KEYPOINT_GRID_H
+
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+
+using namespace std;
+using namespace cv;
+
+/**
+ * Uniform grid spatial index over keypoint positions
+ *
+ * Points are bucketed by cell with a counting sort, so every cell is a
+ * contiguous range of point indices. Points outside the image fall into the
+ * border cells.
+ */
+class KeyPointGrid {
+public:
+  /**
+   * Constructor
+   * @param cellSize Cell side in pixels
+   */
+  explicit KeyPointGrid(float cellSize = 32);
+
+  /**
+   * Index a set of keypoints
+   * @param keypoints Keypoints to index, must outlive the searches
+   * @param imageSize Size of the image the keypoints belong to
+   */
+  void build(const vector<KeyPoint> &keypoints, Size imageSize);
+
+  /**
+   * Find the indexed keypoints within a radius
+   * @param center  Search center
+   * @param radius  Search radius in pixels
+   * @param indices Indices of the keypoints found, in cell order
+   */
+  void radiusSearch(Point2f center, float radius, vector<int> &indices) const;
+
+  /**
+   * Get the number of grid cells
+   * @return grid size in cells
+   */
+  Size getCells() const;
+
+  /**
+   * Get the number of keypoints in a cell
+   * @param x Cell column
+   * @param y Cell row
+   * @return keypoints count
+   */
+  int count(int x, int y) const;
+
+private:
+  /** Cell side in pixels */
+  float cellSize;
+  /** Grid size in cells */
+  Size cells;
+  /** Indexed keypoints */
+  const vector<KeyPoint> *keypoints;
+  /** First entry of every cell in order, one extra at the end */
+  vector<int> cellStart;
+  /** Keypoint indices sorted by cell */
+  vector<int> order;
+
+  /**
+   * Get the cell column or row of a coordinate
+   * @param value Coordinate
+   * @param cells Number of cells in that direction
+   * @return cell, clamped to the grid
+   */
+  int cellOf(float value, int cells) const;
+};
+
+#endif /* KEYPOINT_GRID_H */
@@ -0,0 +1,109 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Pedro Cuadra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+#ifndef LOG_H
+#define LOG_H
+
+#include <atomic>
+#include <iostream>
+#include <sstream>
+
+using namespace std;
+
+#define LOG_LEVEL_TRACE 0
+#define LOG_LEVEL_DEBUG 1
+#define LOG_LEVEL_INFO 2
+#define LOG_LEVEL_WARN 3
+#define LOG_LEVEL_ERROR 4
+#define LOG_LEVEL_OFF 5
+
+/** Messages below this level are stripped at compile time */
+#ifndef LOG_COMPILE_LEVEL
+#define LOG_COMPILE_LEVEL LOG_LEVEL_TRACE
+#endif
+
+/**
+ * Log a message built with stream insertions, e.g. LOG_DEBUG("a" << b). The
+ * message is only formatted when its level is enabled.
+ */
+#define LOG_AT(level, message)                                                 \
+  do {                                                                         \
+    if ((level) >= LOG_COMPILE_LEVEL && Log::isEnabled(level)) {               \
+      Log::stream() << message;                                                \
+      Log::commit(level);                                                      \
+    }                                                                          \
+  } while (0)
+
+#define LOG_TRACE(message) LOG_AT(LOG_LEVEL_TRACE, message)
+#define LOG_DEBUG(message) LOG_AT(LOG_LEVEL_DEBUG, message)
+#define LOG_INFO(message) LOG_AT(LOG_LEVEL_INFO, message)
+#define LOG_WARN(message) LOG_AT(LOG_LEVEL_WARN, message)
+#define LOG_ERROR(message) LOG_AT(LOG_LEVEL_ERROR, message)
+
+/** Log the current function */
+#define LOG_FUNCTION(function) LOG_TRACE("Function: " << function)
+/** Log a trace point at the current file and line */
+#define LOG_POINT() LOG_TRACE(__FILE__ << " (" << __LINE__ << ")")
+
+class Log {
+public:
+  /**
+   * Set the minimum level of the messages to be logged
+   * @param levelVal Level value
+   */
+  static void setLevel(int levelVal);
+
+  /**
+   * Check if a level is enabled
+   * @param levelVal Level to check
+   * @return true if messages of that level are logged
+   */
+  static bool isEnabled(int levelVal) {
+    return levelVal >= level.load(memory_order_relaxed);
+  }
+
+  /**
+   * Get the calling thread's formatting buffer, cleared
+   * @return formatting stream
+   */
+  static ostringstream &stream();
+
+  /**
+   * Queue the message formatted in the calling thread's buffer to be written
+   * by the background sink
+   * @param levelVal Message level
+   */
+  static void commit(int levelVal);
+
+  /**
+   * Block until every queued message has been written
+   */
+  static void flush();
+
+private:
+  /** Minimum logged level */
+  static atomic<int> level;
+};
+
+#endif /* LOG_H */
@@ -29,7 +29,7 @@
 #include <iostream>
 #include <opencv2/core/core.hpp>
 #include <opencv2/core/utility.hpp>
-#include <util/Debug.hpp>
+#include <util/Log.hpp>
 
 using namespace std;
 using namespace cv;
@@ -0,0 +1,76 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Pedro Cuadra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+#ifndef REDUCEDDECODE_H
+#define REDUCEDDECODE_H
+
+#include <string>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/imgcodecs.hpp>
+
+using namespace cv;
+using namespace std;
+
+/**
+ * Image decoding straight to a smaller size
+ *
+ * JPEG decoders can scale the DCT blocks down by 2, 4 or 8 while decoding,
+ * which skips most of the work and memory of a full decode. The largest
+ * reduction still at least as big as the target size is decoded, and only
+ * the residual scaling is left to a resize.
+ */
+class ReducedDecode {
+public:
+  /**
+   * Get the largest decoding reduction keeping an image at least as big as
+   * a target size
+   * @param fullSize Size of the encoded image
+   * @param target   Target size
+   * @return 1, 2, 4 or 8
+   */
+  static int reductionFor(Size fullSize, Size target);
+
+  /**
+   * Get the imread flags of a decoding reduction
+   * @param reduction 1, 2, 4 or 8
+   * @param flags     IMREAD_COLOR or IMREAD_GRAYSCALE
+   * @return imread flags
+   */
+  static int readFlags(int reduction, int flags = IMREAD_COLOR);
+
+  /**
+   * Read an image scaled to a target size
+   * @param path     Image path
+   * @param target   Target size
+   * @param fullSize Expected size of the encoded image, a full decode is
+   *                 done when empty or when the image turns out smaller
+   * @param flags    IMREAD_COLOR or IMREAD_GRAYSCALE
+   * @return image of the target size, empty if it couldn't be read
+   */
+  static Mat read(const string &path, Size target, Size fullSize,
+                  int flags = IMREAD_COLOR);
+};
+
+#endif /* REDUCEDDECODE_H */
@@ -0,0 +1,158 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Pedro Cuadra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+#ifndef RINGBUFFER_H
+#define RINGBUFFER_H
+
+#include <atomic>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Bounded lock-free multi-producer/multi-consumer ring buffer
+ *
+ * Every slot carries a sequence number telling producers and consumers
+ * whether it's free or filled for their lap around the buffer, so the
+ * positions are claimed with a single compare-and-swap and no locks.
+ */
+template <typename T> class RingBuffer {
+public:
+  /**
+   * Constructor
+   * @param capacity Number of slots, rounded up to a power of two
+   */
+  explicit RingBuffer(size_t capacity) {
+    size_t size = 2;
+
+    while (size < capacity) {
+      size <<= 1;
+    }
+
+    this->mask = size - 1;
+    this->slots = vector<Slot>(size);
+
+    for (size_t i = 0; i < size; i++) {
+      this->slots[i].sequence.store(i, memory_order_relaxed);
+    }
+
+    this->head.store(0, memory_order_relaxed);
+    this->tail.store(0, memory_order_relaxed);
+  }
+
+  /**
+   * Queue an item without blocking
+   * @param item Item to queue, moved from on success
+   * @return false if the buffer is full
+   */
+  bool push(T &item) {
+    size_t pos = this->tail.load(memory_order_relaxed);
+    Slot *slot;
+
+    while (true) {
+      slot = &this->slots[pos & this->mask];
+      intptr_t dif = (intptr_t)slot->sequence.load(memory_order_acquire) -
+                     (intptr_t)pos;
+
+      if (dif == 0) {
+        if (this->tail.compare_exchange_weak(pos, pos + 1,
+                                             memory_order_relaxed)) {
+          break;
+        }
+      } else if (dif < 0) {
+        return false;
+      } else {
+        pos = this->tail.load(memory_order_relaxed);
+      }
+    }
+
+    slot->item = std::move(item);
+    slot->sequence.store(pos + 1, memory_order_release);
+
+    return true;
+  }
+
+  /**
+   * Dequeue an item without blocking
+   * @param item Dequeued item
+   * @return false if the buffer is empty
+   */
+  bool pop(T &item) {
+    size_t pos = this->head.load(memory_order_relaxed);
+    Slot *slot;
+
+    while (true) {
+      slot = &this->slots[pos & this->mask];
+      intptr_t dif = (intptr_t)slot->sequence.load(memory_order_acquire) -
+                     (intptr_t)(pos + 1);
+
+      if (dif == 0) {
+        if (this->head.compare_exchange_weak(pos, pos + 1,
+                                             memory_order_relaxed)) {
+          break;
+        }
+      } else if (dif < 0) {
+        return false;
+      } else {
+        pos = this->head.load(memory_order_relaxed);
+      }
+    }
+
+    item = std::move(slot->item);
+    slot->sequence.store(pos + this->mask + 1, memory_order_release);
+
+    return true;
+  }
+
+  /**
+   * Get the number of slots
+   * @return capacity
+   */
+  size_t capacity() const { return this->mask + 1; }
+
+private:
+  /** Buffer slot */
+  struct Slot {
+    /** Lap sequence number */
+    atomic<size_t> sequence;
+    /** Stored item */
+    T item;
+
+    Slot() {}
+    Slot(const Slot &) {}
+  };
+
+  /** Slots */
+  vector<Slot> slots;
+  /** Index mask */
+  size_t mask;
+  /** Next position to be read, kept apart from the write position */
+  alignas(64) atomic<size_t> head;
+  /** Next position to be written */
+  alignas(64) atomic<size_t> tail;
+};
+
+#endif /* RINGBUFFER_H */
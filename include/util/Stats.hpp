@@ -26,7 +26,10 @@
 #define STATS_H
 
 #include <chrono>
+#include <cmath>
 #include <iostream>
+#include <map>
+#include <sstream>
 
 using namespace std;
 
@@ -34,6 +37,10 @@ template <typename T> class Stats {
 public:
   /**
    * Statistics Collector
+   *
+   * Values are summarized on the fly in constant memory. Mean and standard
+   * deviation are exact, percentiles come from a log-linear histogram with
+   * a relative error under 1%.
    * @param name  Statistics name
    * @param units Variable units
    */
@@ -46,7 +53,121 @@ public:
    * Record a new value
    * @param newValue value to be recorded
    */
-  void push_back(T newValue) { this->dataSet.push_back(newValue); }
+  void push_back(T newValue) {
+    double delta = (double)newValue - this->meanValue;
+
+    if (this->count == 0 || newValue < this->minValue) {
+      this->minValue = newValue;
+    }
+
+    if (this->count == 0 || newValue > this->maxValue) {
+      this->maxValue = newValue;
+    }
+
+    // Welford's online mean and variance
+    this->count++;
+    this->meanValue += delta / this->count;
+    this->m2 += delta * ((double)newValue - this->meanValue);
+
+    this->histogram[bucketOf((double)newValue)]++;
+  }
+
+  /**
+   * Merge the values recorded by other collector
+   * @param other Statistics collector to merge
+   */
+  void merge(const Stats<T> &other) {
+    double delta = other.meanValue - this->meanValue;
+    size_t total = this->count + other.count;
+
+    if (other.count == 0) {
+      return;
+    }
+
+    if (this->count == 0 || other.minValue < this->minValue) {
+      this->minValue = other.minValue;
+    }
+
+    if (this->count == 0 || other.maxValue > this->maxValue) {
+      this->maxValue = other.maxValue;
+    }
+
+    // Chan's parallel combination of the partial moments
+    this->m2 += other.m2 + delta * delta * ((double)this->count * other.count) /
+                               total;
+    this->meanValue += delta * other.count / total;
+    this->count = total;
+
+    for (typename map<int, size_t>::const_iterator it = other.histogram.begin();
+         it != other.histogram.end(); it++) {
+      this->histogram[it->first] += it->second;
+    }
+  }
+
+  /**
+   * Get the number of recorded values
+   * @return number of values
+   */
+  size_t size() const { return this->count; }
+
+  /**
+   * Get the mean of the recorded values
+   * @return mean value
+   */
+  double mean() const { return this->meanValue; }
+
+  /**
+   * Get the minimum recorded value
+   * @return minimum value
+   */
+  T minimum() const { return this->minValue; }
+
+  /**
+   * Get the maximum recorded value
+   * @return maximum value
+   */
+  T maximum() const { return this->maxValue; }
+
+  /**
+   * Get the standard deviation of the recorded values
+   * @return standard deviation
+   */
+  double stdDev() const {
+    return this->count ? sqrt(this->m2 / this->count) : 0;
+  }
+
+  /**
+   * Get an estimation of a percentile of the recorded values
+   * @param p Percentile in the [0, 100] range
+   * @return estimated percentile value
+   */
+  double percentile(double p) const {
+    size_t rank = ceil(p / 100.0 * this->count);
+    size_t seen = 0;
+    double value = 0;
+
+    if (this->count == 0) {
+      return 0;
+    }
+
+    rank = rank < 1 ? 1 : rank;
+
+    for (typename map<int, size_t>::const_iterator it = this->histogram.begin();
+         it != this->histogram.end(); it++) {
+      seen += it->second;
+
+      if (seen >= rank) {
+        value = valueOf(it->first);
+        break;
+      }
+    }
+
+    // Buckets are wider than the actual range at the extremes
+    value = value < (double)this->minValue ? (double)this->minValue : value;
+    value = value > (double)this->maxValue ? (double)this->maxValue : value;
+
+    return value;
+  }
 
   /**
    * Return a string statistics summary
@@ -54,49 +175,102 @@ public:
    */
   string str() {
     ostringstream ss;
-    T sum = accumulate(dataSet.begin(), dataSet.end(), 0.0);
-    double mean = 0;
-    vector<T> diff(dataSet.size());
-    double stdDev = 0, sq_sum = 0;
-    T max = 0;
-    T min = 0;
 
     ss.str("");
 
-    if (dataSet.size() == 0) {
+    if (this->count == 0) {
       return ss.str();
     }
 
-    mean = sum / dataSet.size();
-    max = *max_element(dataSet.begin(), dataSet.end());
-    min = *min_element(dataSet.begin(), dataSet.end());
-
-    transform(dataSet.begin(), dataSet.end(), diff.begin(),
-              [mean](double x) { return x - mean; });
-
-    sq_sum = inner_product(diff.begin(), diff.end(), diff.begin(), 0.0);
-    stdDev = sqrt(sq_sum / dataSet.size());
-
     ss << this->name << " - Stats: " << endl;
     ss << "  "
-       << "Data Set size: " << dataSet.size() << endl;
+       << "Data Set size: " << this->count << endl;
     ss << "  "
-       << "Mean: " << mean << this->units << endl;
+       << "Mean: " << this->meanValue << this->units << endl;
     ss << "  "
-       << "Std. Dev.: " << stdDev << endl;
+       << "Std. Dev.: " << this->stdDev() << endl;
     ss << "  "
-       << "Range: [" << min << ", " << max << "]" << endl;
+       << "Range: [" << this->minValue << ", " << this->maxValue << "]"
+       << endl;
+    ss << "  "
+       << "Percentiles: p50 " << this->percentile(50) << this->units
+       << ", p90 " << this->percentile(90) << this->units << ", p99 "
+       << this->percentile(99) << this->units << ", p99.9 "
+       << this->percentile(99.9) << this->units << endl;
 
     return ss.str();
   }
 
 private:
-  /** Data set */
-  vector<T> dataSet;
+  /** Histogram buckets per power of two */
+  static const int subBuckets = 64;
+  /** Keeps positive values buckets above zero, negatives below */
+  static const int bucketOffset = 70000;
+
+  /** Number of recorded values */
+  size_t count = 0;
+  /** Running mean */
+  double meanValue = 0;
+  /** Running sum of squared differences from the mean */
+  double m2 = 0;
+  /** Minimum recorded value */
+  T minValue = 0;
+  /** Maximum recorded value */
+  T maxValue = 0;
+  /** Sparse log-linear histogram, bucket to number of values */
+  map<int, size_t> histogram;
   /** Name of the statistics */
   string name;
   /** Units of the data's values */
   string units;
+
+  /**
+   * Get the histogram bucket of a value, ordered as the values
+   * @param value Value
+   * @return bucket index
+   */
+  static int bucketOf(double value) {
+    int exponent = 0;
+    double mantissa = 0;
+
+    if (value == 0 || std::isnan(value)) {
+      return 0;
+    }
+
+    if (value < 0) {
+      return -bucketOf(-value);
+    }
+
+    // Mantissa in [0.5, 1)
+    mantissa = frexp(value, &exponent);
+
+    return bucketOffset + exponent * subBuckets +
+           (int)((mantissa - 0.5) * 2 * subBuckets);
+  }
+
+  /**
+   * Get the value represented by a histogram bucket
+   * @param bucket Bucket index
+   * @return middle value of the bucket
+   */
+  static double valueOf(int bucket) {
+    int exponent = 0;
+    int sub = 0;
+
+    if (bucket == 0) {
+      return 0;
+    }
+
+    if (bucket < 0) {
+      return -valueOf(-bucket);
+    }
+
+    bucket -= bucketOffset;
+    exponent = (int)floor((double)bucket / subBuckets);
+    sub = bucket - exponent * subBuckets;
+
+    return ldexp(0.5 + (sub + 0.5) / (2.0 * subBuckets), exponent);
+  }
 };
 
 #endif /* STATS_H */
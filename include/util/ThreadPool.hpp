@@ -0,0 +1,100 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Pedro Cuadra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+class ThreadPool {
+public:
+  /**
+   * Fixed size worker pool
+   * @param threads Number of worker threads
+   */
+  explicit ThreadPool(int threads);
+
+  /**
+   * Wait for the pending tasks and join the workers
+   */
+  ~ThreadPool();
+
+  /**
+   * Queue a task to be run by one of the workers
+   * @param task Task to be run
+   */
+  void push(function<void()> task);
+
+  /**
+   * Block until every queued task has finished. The first exception thrown
+   * by a task since the last wait is rethrown here, the other tasks still
+   * run.
+   */
+  void wait();
+
+  /**
+   * Get the number of worker threads
+   * @return number of workers
+   */
+  int size() const;
+
+private:
+  /** Worker threads */
+  vector<thread> workers;
+  /** Pending tasks */
+  queue<function<void()>> tasks;
+  /** Tasks queue lock */
+  mutex lock;
+  /** Signaled when a task is queued or the pool is stopping */
+  condition_variable taskReady;
+  /** Signaled when the last running task finishes */
+  condition_variable allDone;
+  /** Number of queued plus running tasks */
+  int pending = 0;
+  /** Stop request flag */
+  bool stopping = false;
+  /** First exception thrown by a task since the last wait */
+  exception_ptr failure;
+
+  /**
+   * Block until every queued task has finished, lock held
+   * @param guard Tasks queue lock
+   */
+  void waitIdle(unique_lock<mutex> &guard);
+
+  /**
+   * Worker thread loop
+   */
+  void run();
+};
+
+#endif /* THREADPOOL_H */
@@ -0,0 +1,151 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Pedro Cuadra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+using namespace std;
+using namespace std::chrono;
+
+#define TRACE_SPAN_NAME_(line) traceSpan##line
+#define TRACE_SPAN_NAME(line) TRACE_SPAN_NAME_(line)
+#define TRACE_SPAN(name, category)                                             \
+  TraceSpan TRACE_SPAN_NAME(__LINE__)(name, category)
+
+class Trace {
+public:
+  /** Recorded span */
+  struct Event {
+    /** Span name */
+    string name;
+    /** Span category */
+    string category;
+    /** Start time in microseconds since the trace started */
+    long long begin;
+    /** Duration in microseconds */
+    long long duration;
+    /** Recording thread identifier */
+    int thread;
+  };
+
+  /**
+   * Set trace enable flag
+   * @param enableVal Enable flag value
+   */
+  static void setEnable(bool enableVal);
+
+  /**
+   * Get trace enable flag
+   * @return enable flag value
+   */
+  static bool isEnabled() { return enable; }
+
+  /**
+   * Get the current trace time
+   * @return microseconds since the trace started
+   */
+  static long long now();
+
+  /**
+   * Record a finished span
+   * @param event Span to record
+   */
+  static void record(const Event &event);
+
+  /**
+   * Write the recorded spans in Chrome trace event format, loadable by
+   * chrome://tracing and Perfetto
+   * @param path Path of the file to be written
+   */
+  static void write(string path);
+
+private:
+  /** Trace enable flag */
+  static bool enable;
+  /** Trace start time */
+  static steady_clock::time_point origin;
+  /** Recorded spans */
+  static vector<Event> events;
+  /** Recorded spans lock */
+  static mutex lock;
+
+  /**
+   * Get a small identifier of the calling thread
+   * @return thread identifier
+   */
+  static int threadId();
+
+  friend class TraceSpan;
+};
+
+class TraceSpan {
+public:
+  /**
+   * Scoped trace span, recorded when it goes out of scope. Does nothing
+   * when the trace is disabled.
+   * @param name     Span name
+   * @param category Span category
+   */
+  TraceSpan(const char *name, const char *category) {
+    if (Trace::isEnabled()) {
+      this->start(name, category);
+    }
+  }
+
+  /**
+   * Scoped trace span
+   * @param name     Span name
+   * @param category Span category
+   */
+  TraceSpan(const string &name, const char *category) {
+    if (Trace::isEnabled()) {
+      this->start(name, category);
+    }
+  }
+
+  /**
+   * Record the span
+   */
+  ~TraceSpan();
+
+private:
+  /** Span being recorded */
+  Trace::Event event;
+  /** Recording flag */
+  bool active = false;
+
+  /**
+   * Start recording the span
+   * @param name     Span name
+   * @param category Span category
+   */
+  void start(const string &name, const char *category);
+};
+
+#endif /* TRACE_H */
@@ -26,20 +26,90 @@
 
 #include <detectors/FeatureDetect.hpp>
 
-#include <util/Debug.hpp>
+#include <util/Log.hpp>
+#include <util/Trace.hpp>
 
 using namespace cv::xfeatures2d;
 using namespace std;
 
+const String FeatureDetect::options =
+    "{tiles        | 1  | Detection Tiles per Side }"
+    "{tile_overlap | 32 | Tiles Overlap            }"
+    "{tile_budget  | 0  | Keypoints per Tile       }";
+
+/**
+ * Detect keypoints in a set of tiles
+ */
+class TileDetectBody : public ParallelLoopBody {
+public:
+  /**
+   * Tiles detection loop body
+   * @param detector  Detector to be used
+   * @param image     Input image
+   * @param tiles     Tiles to run the detection on
+   * @param owned     Region owned by each tile
+   * @param budget    Maximum number of keypoints per tile, 0 for no limit
+   * @param keyPoints Keypoints found per tile
+   */
+  TileDetectBody(Ptr<Feature2D> detector, const Mat &image,
+                 const vector<Rect> &tiles, const vector<Rect> &owned,
+                 int budget, vector<vector<KeyPoint>> &keyPoints)
+      : detector(detector), image(image), tiles(tiles), owned(owned),
+        budget(budget), keyPoints(keyPoints) {}
+
+  virtual void operator()(const Range &range) const {
+    vector<KeyPoint> tileKeyPoints;
+
+    for (int i = range.start; i < range.end; i++) {
+      tileKeyPoints.clear();
+      detector->detect(image(tiles[i]), tileKeyPoints);
+
+      for (size_t k = 0; k < tileKeyPoints.size(); k++) {
+        tileKeyPoints[k].pt.x += tiles[i].x;
+        tileKeyPoints[k].pt.y += tiles[i].y;
+
+        // Duplicates found in the overlap band are dropped by all the
+        // tiles but the one owning their position
+        if (owned[i].contains(Point(cvFloor(tileKeyPoints[k].pt.x),
+                                    cvFloor(tileKeyPoints[k].pt.y)))) {
+          keyPoints[i].push_back(tileKeyPoints[k]);
+        }
+      }
+
+      if (budget > 0) {
+        KeyPointsFilter::retainBest(keyPoints[i], budget);
+      }
+    }
+  }
+
+private:
+  Ptr<Feature2D> detector;
+  const Mat &image;
+  const vector<Rect> &tiles;
+  const vector<Rect> &owned;
+  int budget;
+  vector<vector<KeyPoint>> &keyPoints;
+};
+
 /**
  * Feature Detection Wrapper Class
  */
 FeatureDetect::FeatureDetect(CommandLineParser parser, string name)
     : timingStats(name + " - Timing", "s"),
+      borrowedBytesStats(name + " - Input Copy Avoided", "B"),
       keyPointsStats(name + " - Keypoints", "") {
   this->showEnable = parser.has("show");
   this->name = name;
   this->allEnable = parser.has("all");
+  this->tiles = max(1, parser.get<int>("tiles"));
+  this->tileOverlap = max(0, parser.get<int>("tile_overlap"));
+  this->tileBudget = max(0, parser.get<int>("tile_budget"));
+
+  if (this->tiles > 1) {
+    paramsString << "  Tiles: " << this->tiles << "x" << this->tiles << endl;
+    paramsString << "  Tiles Overlap: " << this->tileOverlap << endl;
+    paramsString << "  Keypoints per Tile: " << this->tileBudget << endl;
+  }
 }
 
 /**
@@ -66,17 +136,68 @@ void FeatureDetect::_runCompute() {
     return;
   }
 
-  STACK_TRACE(__FUNCTION__);
+  LOG_FUNCTION(__FUNCTION__);
+  TRACE_SPAN(this->name, "compute");
 
   this->runCompute();
+  this->outputDirty = true;
 }
 
 /**
  * Run feature detection algorithm
  */
 void FeatureDetect::runDetect() {
-  STACK_TRACE(__FUNCTION__);
-  detector->detect(this->inputImage, this->keyPoints);
+  LOG_FUNCTION(__FUNCTION__);
+  this->detectKeyPoints(this->detector, this->inputImage, this->keyPoints);
+}
+
+/**
+ * Detect keypoints, tiled if enabled
+ */
+void FeatureDetect::detectKeyPoints(Ptr<Feature2D> detector, const Mat &image,
+                                    vector<KeyPoint> &keyPoints) {
+  vector<Rect> tileRects, ownedRects;
+  vector<vector<KeyPoint>> tileKeyPoints;
+  Rect imageRect(0, 0, image.cols, image.rows);
+  int x0, x1, y0, y1;
+
+  LOG_FUNCTION(__FUNCTION__);
+
+  if (this->tiles <= 1) {
+    detector->detect(image, keyPoints);
+    return;
+  }
+
+  // Split the image in a grid of owned regions, each tile being its owned
+  // region grown by the overlap
+  for (int row = 0; row < this->tiles; row++) {
+    y0 = row * image.rows / this->tiles;
+    y1 = (row + 1) * image.rows / this->tiles;
+
+    for (int col = 0; col < this->tiles; col++) {
+      x0 = col * image.cols / this->tiles;
+      x1 = (col + 1) * image.cols / this->tiles;
+
+      ownedRects.push_back(Rect(x0, y0, x1 - x0, y1 - y0));
+      tileRects.push_back(Rect(x0 - this->tileOverlap, y0 - this->tileOverlap,
+                               x1 - x0 + 2 * this->tileOverlap,
+                               y1 - y0 + 2 * this->tileOverlap) &
+                          imageRect);
+    }
+  }
+
+  tileKeyPoints.resize(tileRects.size());
+
+  parallel_for_(Range(0, tileRects.size()),
+                TileDetectBody(detector, image, tileRects, ownedRects,
+                               this->tileBudget, tileKeyPoints));
+
+  keyPoints.clear();
+
+  for (size_t i = 0; i < tileKeyPoints.size(); i++) {
+    keyPoints.insert(keyPoints.end(), tileKeyPoints[i].begin(),
+                     tileKeyPoints[i].end());
+  }
 }
 
 /**
@@ -88,12 +209,15 @@ void FeatureDetect::_runDetect() {
     return;
   }
 
-  STACK_TRACE(__FUNCTION__);
+  LOG_FUNCTION(__FUNCTION__);
+  TRACE_SPAN(this->name, "detect");
 
   timing.start();
   this->runDetect();
   timing.end();
 
+  this->outputDirty = true;
+
   this->collectStats(timing.getDelta());
 
   if (keyPoints.size()) {
@@ -104,36 +228,70 @@ void FeatureDetect::_runDetect() {
 /**
  * Apply detection algorithm
  */
-void FeatureDetect::detect(Mat inputImage) {
+void FeatureDetect::detect(const Mat &inputImage) {
   if (!(this->enable || this->allEnable)) {
     return;
   }
 
-  STACK_TRACE(__FUNCTION__);
-  inputImage.copyTo(this->inputImage);
+  this->detect(makePtr<Frame>(inputImage));
+}
+
+/**
+ * Apply detection algorithm to a shared frame
+ */
+void FeatureDetect::detect(Ptr<Frame> frame) {
+  if (!(this->enable || this->allEnable)) {
+    return;
+  }
+
+  LOG_FUNCTION(__FUNCTION__);
+  this->borrowInput(frame);
   this->_runDetect();
   this->show();
 }
 
 /**
- * Apply detection algorithm
+ * Compute the descriptors
+ */
+void FeatureDetect::compute(const Mat &inputImage) {
+  if (!(this->enable || this->allEnable)) {
+    return;
+  }
+
+  this->compute(makePtr<Frame>(inputImage));
+}
+
+/**
+ * Compute the descriptors of a shared frame
  */
-void FeatureDetect::compute(Mat inputImage) {
-  STACK_TRACE(__FUNCTION__);
+void FeatureDetect::compute(Ptr<Frame> frame) {
+  LOG_FUNCTION(__FUNCTION__);
   if (!(this->enable || this->allEnable)) {
     return;
   }
 
-  inputImage.copyTo(this->inputImage);
+  this->borrowInput(frame);
   this->_runCompute();
   this->show();
 }
 
+/**
+ * Borrow the input frame
+ */
+void FeatureDetect::borrowInput(Ptr<Frame> frame) {
+  this->frame = frame;
+
+  // Only the header is copied, the pixel buffer is shared with the caller
+  this->inputImage = frame->getImage();
+  this->borrowedBytesStats.push_back(this->inputImage.total() *
+                                     this->inputImage.elemSize());
+}
+
 /**
  * Re-apply the detection algorithm to the stored input image
  */
 void FeatureDetect::redetect() {
-  STACK_TRACE(__FUNCTION__);
+  LOG_FUNCTION(__FUNCTION__);
   this->_runDetect();
   this->drawOutput();
 }
@@ -142,7 +300,7 @@ void FeatureDetect::redetect() {
  * Update the output image
  */
 void FeatureDetect::updateOutputImage() {
-  STACK_TRACE(__FUNCTION__);
+  LOG_FUNCTION(__FUNCTION__);
   drawKeypoints(this->inputImage, keyPoints, this->outputImage, Scalar::all(-1),
                 DrawMatchesFlags::DRAW_RICH_KEYPOINTS);
 }
@@ -151,8 +309,10 @@ void FeatureDetect::updateOutputImage() {
  * Draw ouput image to the GUI
  */
 void FeatureDetect::drawOutput() {
-  STACK_TRACE(__FUNCTION__);
+  LOG_FUNCTION(__FUNCTION__);
+  // Controls may have changed the rendering, always redraw
   updateOutputImage();
+  this->outputDirty = false;
 
   imshow(this->name, this->outputImage);
 }
@@ -161,17 +321,17 @@ void FeatureDetect::drawOutput() {
  * Show the GUI
  */
 void FeatureDetect::show() {
-  STACK_TRACE(__FUNCTION__);
+  LOG_FUNCTION(__FUNCTION__);
   if (!(this->enable || this->allEnable)) {
     return;
   }
 
+  // Rendering is deferred until the output image is requested
   if (!this->showEnable) {
-    updateOutputImage();
     return;
   }
 
-  Debug::printMessage("Running FeatureDetect::show");
+  LOG_DEBUG("Running FeatureDetect::show");
 
   if (paramsString.str().size()) {
     cout << this->name << " - Params:" << endl;
@@ -203,6 +363,7 @@ void FeatureDetect::printStats() {
   }
 
   cout << timingStats.str();
+  cout << borrowedBytesStats.str();
   cout << keyPointsStats.str();
   cout << statsString.str();
 }
@@ -211,7 +372,7 @@ void FeatureDetect::printStats() {
  * Dump stats to file
  */
 void FeatureDetect::dumpStatsToFile(string path) {
-  STACK_TRACE(__FUNCTION__);
+  LOG_FUNCTION(__FUNCTION__);
   if (!(this->enable || this->allEnable)) {
     return;
   }
@@ -223,6 +384,7 @@ void FeatureDetect::dumpStatsToFile(string path) {
   }
 
   outFile << timingStats.str();
+  outFile << borrowedBytesStats.str();
   outFile << keyPointsStats.str();
   outFile << statsString.str();
 }
@@ -231,7 +393,7 @@ void FeatureDetect::dumpStatsToFile(string path) {
  * Collect timing stats
  */
 void FeatureDetect::collectStats(double delta) {
-  STACK_TRACE(__FUNCTION__);
+  LOG_FUNCTION(__FUNCTION__);
   this->timingStats.push_back(delta);
 }
 
@@ -247,7 +409,20 @@ void FeatureDetect::writeImage(string path) {
   if (!(this->enable || this->allEnable)) {
     return;
   }
-  imwrite(path, this->outputImage);
+  imwrite(path, this->getOutputImage());
+}
+
+/**
+ * Get the output image, rendered on demand
+ */
+const Mat &FeatureDetect::getOutputImage() {
+  if (this->outputDirty) {
+    LOG_FUNCTION(__FUNCTION__);
+    updateOutputImage();
+    this->outputDirty = false;
+  }
+
+  return this->outputImage;
 }
 
 /**
@@ -255,6 +430,36 @@ void FeatureDetect::writeImage(string path) {
  */
 bool FeatureDetect::getEnable() { return this->enable || this->allEnable; }
 
-vector<KeyPoint> FeatureDetect::getKeyPoints() { return this->keyPoints; }
+/**
+ * Get the obtained keypoints
+ */
+const vector<KeyPoint> &FeatureDetect::getKeyPoints() const {
+  return this->keyPoints;
+}
+
+/**
+ * Get the obtained descriptors
+ */
+const Mat &FeatureDetect::getDescriptors() const { return this->descriptors; }
+
+/**
+ * Move the obtained keypoints out of the detector
+ */
+vector<KeyPoint> FeatureDetect::takeKeyPoints() {
+  vector<KeyPoint> keyPoints;
 
-Mat FeatureDetect::getDescriptors() { return this->descriptors; }
+  keyPoints.swap(this->keyPoints);
+
+  return keyPoints;
+}
+
+/**
+ * Move the obtained descriptors out of the detector
+ */
+Mat FeatureDetect::takeDescriptors() {
+  Mat descriptors = this->descriptors;
+
+  this->descriptors.release();
+
+  return descriptors;
+}
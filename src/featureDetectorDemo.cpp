@@ -56,8 +56,13 @@
 #include <detectors/SurfDetect.hpp>
 #include <detectors/ThresholdDetect.hpp>
 #include <detectors/VggDetect.hpp>
-#include <util/Debug.hpp>
+#include <util/Frame.hpp>
+#include <util/ImagePrefetcher.hpp>
+#include <util/Log.hpp>
+#include <util/Stats.hpp>
+#include <util/ThreadPool.hpp>
 #include <util/Timing.hpp>
+#include <util/Trace.hpp>
 
 using namespace cv;
 using namespace cv::xfeatures2d;
@@ -71,8 +76,12 @@ static String keys =
     "{indir          |      | Input Directory Path  }"
     "{outdir         |      | Output Directory Path }"
     "{show           |      | Display images        }"
-    "{all            |      | All Detectors Enable  }" +
-    AdaptativeThresholdDetect::options + CannyDetect::options +
+    "{all            |      | All Detectors Enable  }"
+    "{threads        | 0    | Detector Threads      }"
+    "{prefetch       | 0    | Prefetched Images     }"
+    "{prefetch_mb    | 512  | Prefetch Memory Cap   }"
+    "{trace          |      | Trace Output Path     }" +
+    FeatureDetect::options + AdaptativeThresholdDetect::options + CannyDetect::options +
     FastDetect::options + FindContourDetect::options +
     HarrisCornerDetect::options + HarrisLaplaceDetect::options +
     HoughDetect::options + KMeanDetect::options + LucidDetect::options +
@@ -81,8 +90,63 @@ static String keys =
     SimpleBlobDetect::options + StarDetectorDetect::options +
     SurfDetect::options + ThresholdDetect::options + VggDetect::options;
 
+/**
+ * Run the enabled detectors of a pool on a frame
+ * @param algPool Detectors pool
+ * @param frame   Input frame
+ * @param workers Worker threads, run sequentially if NULL
+ */
+static void runDetectors(vector<FeatureDetect *> &algPool, Ptr<Frame> frame,
+                         ThreadPool *workers) {
+  for (int i = 0; i < algPool.size(); i++) {
+    FeatureDetect *detector = algPool[i];
+
+    if (!detector->getEnable()) {
+      continue;
+    }
+
+    if (!workers) {
+      detector->detect(frame);
+      continue;
+    }
+
+    // Each detector owns its stats, so a single task per detector keeps
+    // the timings free of cross-thread interference
+    workers->push([detector, frame] { detector->detect(frame); });
+  }
+}
+
+/**
+ * Write the output images of the enabled detectors of a pool
+ * @param algPool Detectors pool
+ * @param path    Output image path
+ */
+static void writeImages(vector<FeatureDetect *> &algPool, string path) {
+  TRACE_SPAN("imwrite", "write");
+
+  for (int i = 0; i < algPool.size(); i++) {
+    if (!algPool[i]->getEnable()) {
+      continue;
+    }
+
+    algPool[i]->writeImage(path);
+    LOG_DEBUG("Writting - " << path);
+  }
+}
+
 int main(int argc, char **argv) {
-  Mat inputImage, inputImageColor;
+  Mat inputImage;
+  Ptr<Frame> colorFrame, grayFrame;
+  Ptr<ThreadPool> workers;
+  Ptr<ImagePrefetcher> prefetcher;
+  ImagePrefetcher::PrefetchedImage prefetched;
+  Timing frameTiming, stallTiming;
+  Stats<double> frameStats("Frame - Wall Time", "s");
+  Stats<double> stallStats("Frame - I/O Stall", "s");
+  Stats<int> buildStats("Frame - Derivations Built", "");
+  Stats<int> reuseStats("Frame - Derivations Reused", "");
+  double frameTotal = 0, stallTotal = 0;
+  int idx = 0;
   int k = 0;
   CommandLineParser parser(argc, argv, keys);
   string inputImagePath = parser.get<string>("in");
@@ -92,7 +156,8 @@ int main(int argc, char **argv) {
   struct dirent *ent;
   bool enableGui = parser.has("show") && !parser.has("indir");
 
-  Debug::setEnable(parser.has("v"));
+  Log::setLevel(parser.has("v") ? LOG_LEVEL_TRACE : LOG_LEVEL_WARN);
+  Trace::setEnable(parser.has("trace"));
 
   if (parser.has("v")) {
     cout << "OpenCV Version: " << CV_MAJOR_VERSION << "." << CV_MINOR_VERSION
@@ -149,6 +214,11 @@ int main(int argc, char **argv) {
     }
   }
 
+  // The GUI must be driven from the main thread
+  if (parser.get<int>("threads") > 0 && !parser.has("show")) {
+    workers = makePtr<ThreadPool>(parser.get<int>("threads"));
+  }
+
   // Add all algorithms to the pool (COLOR ONLY)
   algColorPool.push_back(new LucidDetect(parser));
   algColorPool.push_back(new KMeanDetect(parser));
@@ -172,68 +242,89 @@ int main(int argc, char **argv) {
   algGrayScalePool.push_back(new HarrisLaplaceDetect(parser));
   algGrayScalePool.push_back(new HoughDetect(parser));
 
-  for (int idx = 0; idx < lInputImagePath.size(); idx++) {
+  prefetcher = makePtr<ImagePrefetcher>(
+      lInputImagePath, parser.get<int>("prefetch"),
+      (size_t)parser.get<int>("prefetch_mb") * 1024 * 1024, IMREAD_COLOR);
+
+  while (true) {
+    // Time spent waiting for the image to be decoded
+    stallTiming.start();
 
-    Debug::printMessage("Reading - " + lInputImagePath[idx]);
+    if (!prefetcher->next(prefetched)) {
+      break;
+    }
 
-    inputImage = imread(lInputImagePath[idx], CV_LOAD_IMAGE_COLOR);
+    stallTiming.end();
+    stallStats.push_back(stallTiming.getDelta());
+    stallTotal += stallTiming.getDelta();
+
+    idx = prefetched.idx;
+    inputImage = prefetched.image;
 
     if (inputImage.empty()) {
       cout << "Oopps! Couldn't read the inputImage!" << endl;
       continue;
     }
 
-    TRACE_LINE(__FILE__, __LINE__);
+    TRACE_SPAN("frame", "frame");
+
+    frameTiming.start();
+    colorFrame = makePtr<Frame>(inputImage);
+
+    LOG_POINT();
 
     if (enableGui) {
       namedWindow("Original Color", WINDOW_GUI_EXPANDED);
       imshow("Original Color", inputImage);
     }
 
-    TRACE_LINE(__FILE__, __LINE__);
+    LOG_POINT();
 
     // Run all color detections
-    for (int i = 0; i < algColorPool.size(); i++) {
-      if (!algColorPool[i]->getEnable()) {
-        continue;
-      }
-
-      algColorPool[i]->detect(inputImage);
-
-      if (idx < lOutputImagePath.size()) {
-        algColorPool[i]->writeImage(lOutputImagePath[idx]);
-        Debug::printMessage("Writting - " + lOutputImagePath[idx]);
-      }
-    }
+    runDetectors(algColorPool, colorFrame, workers.get());
 
-    TRACE_LINE(__FILE__, __LINE__);
+    LOG_POINT();
 
     // Convert image to gray scale
-    cvtColor(inputImage, inputImage, COLOR_RGB2GRAY);
+    grayFrame = makePtr<Frame>(colorFrame->getGray());
     if (enableGui) {
       namedWindow("Original", WINDOW_GUI_EXPANDED);
-      imshow("Original", inputImage);
+      imshow("Original", grayFrame->getImage());
     }
 
-    TRACE_LINE(__FILE__, __LINE__);
+    LOG_POINT();
 
     // Run all grary scale detection
-    for (int i = 0; i < algGrayScalePool.size(); i++) {
-      if (!algGrayScalePool[i]->getEnable()) {
-        continue;
-      }
+    runDetectors(algGrayScalePool, grayFrame, workers.get());
 
-      algGrayScalePool[i]->detect(inputImage);
+    if (workers) {
+      workers->wait();
+    }
 
-      if (idx < lOutputImagePath.size()) {
-        algGrayScalePool[i]->writeImage(lOutputImagePath[idx]);
-        Debug::printMessage("Writting - " + lOutputImagePath[idx]);
-      }
+    // Reuses are the builds avoided by sharing the frames among detectors
+    buildStats.push_back(
+        (int)(colorFrame->getBuilds() + grayFrame->getBuilds()));
+    reuseStats.push_back(
+        (int)(colorFrame->getReuses() + grayFrame->getReuses()));
+
+    frameTiming.end();
+    frameStats.push_back(frameTiming.getDelta());
+    frameTotal += frameTiming.getDelta();
+
+    LOG_POINT();
+
+    // Detectors share the output path, write in pool order
+    if (idx < lOutputImagePath.size()) {
+      writeImages(algColorPool, lOutputImagePath[idx]);
+      writeImages(algGrayScalePool, lOutputImagePath[idx]);
     }
 
-    TRACE_LINE(__FILE__, __LINE__);
+    LOG_POINT();
   }
 
+  // Keep the debug messages ahead of the stats
+  Log::flush();
+
   for (int i = 0; i < algColorPool.size(); i++) {
     algColorPool[i]->printStats();
 
@@ -252,6 +343,19 @@ int main(int argc, char **argv) {
     }
   }
 
+  cout << "Detector Threads: " << (workers ? workers->size() : 0) << endl;
+  cout << "Prefetched Images: " << parser.get<int>("prefetch") << endl;
+  cout << frameStats.str();
+  cout << stallStats.str();
+  cout << buildStats.str();
+  cout << reuseStats.str();
+  cout << "Time Computing: " << frameTotal << "s" << endl;
+  cout << "Time Stalled on I/O: " << stallTotal << "s" << endl;
+
+  if (parser.has("trace")) {
+    Trace::write(parser.get<string>("trace"));
+  }
+
   cout << "Benchmark Finished" << endl;
 
   // Wait for the ESC key to be pressed
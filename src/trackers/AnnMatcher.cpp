@@ -0,0 +1,278 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Pedro Cuadra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+#include <trackers/AnnMatcher.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+#include <trackers/TileScan.hpp>
+#include <util/Timing.hpp>
+#include <util/Trace.hpp>
+
+/**
+ * Approximate nearest neighbour matcher
+ */
+AnnMatcher::AnnMatcher(const Params &params)
+    : params(params), buildStats("ANN Index - Build", "s"),
+      searchStats("ANN Index - Search", "s"),
+      recallStats("ANN Index - Recall@1", "") {}
+
+bool AnnMatcher::isMaskSupported() const { return false; }
+
+Ptr<DescriptorMatcher> AnnMatcher::clone(bool emptyTrainData) const {
+  Ptr<AnnMatcher> matcher = makePtr<AnnMatcher>(this->params);
+
+  if (!emptyTrainData) {
+    for (size_t i = 0; i < this->trainDescCollection.size(); i++) {
+      matcher->trainDescCollection.push_back(
+          this->trainDescCollection[i].clone());
+    }
+  }
+
+  return matcher;
+}
+
+void AnnMatcher::add(InputArrayOfArrays descriptors) {
+  DescriptorMatcher::add(descriptors);
+
+  // Mirror the UMats, the index is built from host memory
+  for (size_t i = 0; i < this->utrainDescCollection.size(); i++) {
+    this->trainDescCollection.push_back(
+        this->utrainDescCollection[i].getMat(ACCESS_READ).clone());
+  }
+
+  this->utrainDescCollection.clear();
+  this->index.release();
+}
+
+void AnnMatcher::clear() {
+  DescriptorMatcher::clear();
+  this->index.release();
+}
+
+bool AnnMatcher::isTrained() const { return !this->index.empty(); }
+
+void AnnMatcher::setReference(const Mat &reference) {
+  this->clear();
+  this->add(vector<Mat>(1, reference));
+  this->train();
+}
+
+void AnnMatcher::train() {
+  Timing timing;
+
+  if (this->isTrained() || this->trainDescCollection.empty()) {
+    return;
+  }
+
+  TRACE_SPAN("AnnMatcher", "index");
+  timing.start();
+
+  this->imageStart.clear();
+  this->indexed.release();
+
+  for (size_t i = 0; i < this->trainDescCollection.size(); i++) {
+    this->imageStart.push_back(this->indexed.rows);
+    this->indexed.push_back(this->trainDescCollection[i]);
+  }
+
+  if (this->indexed.empty()) {
+    return;
+  }
+
+  if (this->indexed.type() == CV_8U) {
+    this->index = makePtr<flann::Index>(
+        this->indexed,
+        flann::LshIndexParams(this->params.lshTables, this->params.lshKeySize,
+                              this->params.lshMultiProbe),
+        cvflann::FLANN_DIST_HAMMING);
+  } else {
+    CV_Assert(this->indexed.type() == CV_32F);
+    this->index = makePtr<flann::Index>(
+        this->indexed, flann::KDTreeIndexParams(this->params.trees),
+        cvflann::FLANN_DIST_L2);
+  }
+
+  timing.end();
+  this->buildStats.push_back(timing.getDelta());
+}
+
+void AnnMatcher::toMatches(const Mat &indices, const Mat &distances,
+                           vector<vector<DMatch>> &matches) const {
+  bool squared = this->indexed.type() != CV_8U;
+
+  for (int q = 0; q < indices.rows; q++) {
+    for (int n = 0; n < indices.cols; n++) {
+      int idx = indices.at<int>(q, n);
+      float distance = distances.at<float>(q, n);
+      int img;
+
+      // LSH leaves the slots it couldn't fill unset
+      if (idx < 0 || idx >= this->indexed.rows) {
+        continue;
+      }
+
+      img = upper_bound(this->imageStart.begin(), this->imageStart.end(),
+                        idx) -
+            this->imageStart.begin() - 1;
+
+      // The L2 index reports squared distances
+      matches[q].push_back(DMatch(q, idx - this->imageStart[img], img,
+                                  squared ? sqrt(distance) : distance));
+    }
+  }
+}
+
+void AnnMatcher::knnMatchImpl(InputArray queryDescriptors,
+                              vector<vector<DMatch>> &matches, int k,
+                              InputArrayOfArrays, bool compactResult) {
+  TRACE_SPAN("AnnMatcher", "match");
+  Mat query = queryDescriptors.getMat();
+  Mat indices, distances;
+  Timing timing;
+
+  matches.assign(query.rows, vector<DMatch>());
+  this->train();
+
+  if (query.empty() || !this->isTrained() || k <= 0) {
+    return;
+  }
+
+  k = min(k, this->indexed.rows);
+
+  timing.start();
+  indices.create(query.rows, k, CV_32S);
+  indices.setTo(Scalar::all(-1));
+  this->index->knnSearch(query, indices, distances, k,
+                         flann::SearchParams(this->params.checks));
+  distances.convertTo(distances, CV_32F);
+  this->toMatches(indices, distances, matches);
+  timing.end();
+
+  this->searchStats.push_back(timing.getDelta());
+
+  if (this->params.checkRecall) {
+    this->checkRecall(query, matches);
+  }
+
+  if (compactResult) {
+    compactMatches(matches);
+  }
+}
+
+void AnnMatcher::radiusMatchImpl(InputArray queryDescriptors,
+                                 vector<vector<DMatch>> &matches,
+                                 float maxDistance, InputArrayOfArrays,
+                                 bool compactResult) {
+  Mat query = queryDescriptors.getMat();
+  bool squared;
+  Mat indices, distances;
+
+  matches.assign(query.rows, vector<DMatch>());
+  this->train();
+
+  if (query.empty() || !this->isTrained()) {
+    return;
+  }
+
+  squared = this->indexed.type() != CV_8U;
+
+  for (int q = 0; q < query.rows; q++) {
+    vector<vector<DMatch>> found(1);
+
+    indices.create(1, this->indexed.rows, CV_32S);
+    indices.setTo(Scalar::all(-1));
+    this->index->radiusSearch(
+        query.row(q), indices, distances,
+        squared ? maxDistance * maxDistance : maxDistance, this->indexed.rows,
+        flann::SearchParams(this->params.checks));
+    distances.convertTo(distances, CV_32F);
+    this->toMatches(indices, distances, found);
+
+    for (size_t n = 0; n < found[0].size(); n++) {
+      found[0][n].queryIdx = q;
+    }
+
+    matches[q].swap(found[0]);
+    sort(matches[q].begin(), matches[q].end());
+  }
+
+  if (compactResult) {
+    compactMatches(matches);
+  }
+}
+
+void AnnMatcher::checkRecall(const Mat &query,
+                             const vector<vector<DMatch>> &matches) {
+  int normType = this->indexed.type() == CV_8U ? NORM_HAMMING : NORM_L2;
+  BFMatcher exact(normType);
+  vector<vector<DMatch>> exactMatches, stacked(matches);
+
+  exact.knnMatch(query, this->indexed, exactMatches, 1);
+
+  // Train indices into the stacked descriptors of all the images
+  for (size_t q = 0; q < stacked.size(); q++) {
+    for (size_t n = 0; n < stacked[q].size(); n++) {
+      stacked[q][n].trainIdx += this->imageStart[stacked[q][n].imgIdx];
+    }
+  }
+
+  this->recallStats.push_back(
+      recall(query, this->indexed, normType, stacked, exactMatches));
+}
+
+double AnnMatcher::recall(const Mat &query, const Mat &train, int normType,
+                          const vector<vector<DMatch>> &matches,
+                          const vector<vector<DMatch>> &exact) {
+  size_t hits = 0;
+  size_t total = 0;
+
+  for (size_t q = 0; q < exact.size() && q < matches.size(); q++) {
+    if (exact[q].empty()) {
+      continue;
+    }
+
+    total++;
+    if (matches[q].empty()) {
+      continue;
+    }
+
+    // Recomputed, so ties at the nearest distance count as hits
+    double distance =
+        norm(query.row((int)q), train.row(matches[q][0].trainIdx), normType);
+
+    if (distance <= exact[q][0].distance * (1 + 1e-5) + 1e-6) {
+      hits++;
+    }
+  }
+
+  return total ? (double)hits / total : 1;
+}
+
+void AnnMatcher::printStats() {
+  cout << this->buildStats.str();
+  cout << this->searchStats.str();
+  cout << this->recallStats.str();
+}
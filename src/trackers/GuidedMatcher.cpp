@@ -0,0 +1,190 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Pedro Cuadra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+#include <trackers/GuidedMatcher.hpp>
+
+#include <cfloat>
+#include <cmath>
+
+#include <util/HammingDistance.hpp>
+#include <util/Int8Distance.hpp>
+#include <util/KeyPointGrid.hpp>
+#include <util/Trace.hpp>
+
+/**
+ * Descriptor distance, L2 for float and int8 descriptors and Hamming for
+ * binary ones
+ */
+static float descriptorDistance(const Mat &desc1, int i, const Mat &desc2,
+                                int j) {
+  if (desc1.depth() == CV_8U) {
+    return (float)HammingDistance::distance(desc1.ptr<uint8_t>(i),
+                                            desc2.ptr<uint8_t>(j), desc1.cols);
+  }
+
+  // Quantized units, the ratio test doesn't depend on the scale
+  if (desc1.depth() == CV_8S) {
+    return std::sqrt((float)Int8Distance::distance(
+        desc1.ptr<int8_t>(i), desc2.ptr<int8_t>(j), desc1.cols));
+  }
+
+  const float *a = desc1.ptr<float>(i);
+  const float *b = desc2.ptr<float>(j);
+  float sum = 0;
+
+  for (int k = 0; k < desc1.cols; k++) {
+    float d = a[k] - b[k];
+    sum += d * d;
+  }
+
+  return std::sqrt(sum);
+}
+
+/**
+ * Constructor
+ */
+GuidedMatcher::GuidedMatcher(float radius, float matchConf,
+                             int numMatchesThresh1, int numMatchesThresh2)
+    : HomographyFeaturesMatcher(false, numMatchesThresh1, numMatchesThresh2),
+      radius(radius), matchConf(matchConf),
+      comparisonStats("Guided Matcher - Descriptor Comparisons", ""),
+      fractionStats("Guided Matcher - Exhaustive Comparisons Fraction", "%") {
+}
+
+/**
+ * Set the predicted homography
+ */
+void GuidedMatcher::setPrediction(const Mat &H) {
+  if (H.empty()) {
+    this->prediction.release();
+    return;
+  }
+
+  H.convertTo(this->prediction, CV_64F);
+}
+
+/**
+ * Get the predicted homography
+ */
+const Mat &GuidedMatcher::getPrediction() const { return this->prediction; }
+
+/**
+ * Homography guided matching
+ */
+void GuidedMatcher::match(const ImageFeatures &features1,
+                          const ImageFeatures &features2,
+                          MatchesInfo &matchesInfo) {
+  TRACE_SPAN("GuidedMatcher", "match");
+  Mat desc1 = features1.descriptors.getMat(ACCESS_READ);
+  Mat desc2 = features2.descriptors.getMat(ACCESS_READ);
+  float ratio = 1.f - this->matchConf;
+  vector<Point2f> points, projected;
+  vector<int> candidates;
+  // Best query per train keypoint, keeps the matches one to one
+  vector<int> bestQuery(features2.keypoints.size(), -1);
+  vector<float> bestDistance(features2.keypoints.size(), FLT_MAX);
+  KeyPointGrid grid(this->radius);
+  double comparisons = 0;
+
+  matchesInfo.matches.clear();
+
+  if (desc1.empty() || desc2.empty()) {
+    return;
+  }
+
+  CV_Assert(desc1.type() == desc2.type() && desc1.cols == desc2.cols);
+
+  if (!this->prediction.empty()) {
+    KeyPoint::convert(features1.keypoints, points);
+    perspectiveTransform(points, projected, this->prediction);
+    grid.build(features2.keypoints, features2.img_size);
+  } else {
+    candidates.resize(features2.keypoints.size());
+
+    for (size_t j = 0; j < candidates.size(); j++) {
+      candidates[j] = (int)j;
+    }
+  }
+
+  for (int i = 0; i < desc1.rows; i++) {
+    float best = FLT_MAX, second = FLT_MAX;
+    int bestIdx = -1;
+
+    if (!this->prediction.empty()) {
+      grid.radiusSearch(projected[i], this->radius, candidates);
+    }
+
+    for (size_t c = 0; c < candidates.size(); c++) {
+      float d = descriptorDistance(desc1, i, desc2, candidates[c]);
+
+      if (d < best) {
+        second = best;
+        best = d;
+        bestIdx = candidates[c];
+      } else if (d < second) {
+        second = d;
+      }
+    }
+
+    comparisons += candidates.size();
+
+    // A lone candidate is already disambiguated by the geometry
+    if (bestIdx < 0 || (second < FLT_MAX && best >= ratio * second)) {
+      continue;
+    }
+
+    if (best < bestDistance[bestIdx]) {
+      bestDistance[bestIdx] = best;
+      bestQuery[bestIdx] = i;
+    }
+  }
+
+  for (size_t j = 0; j < bestQuery.size(); j++) {
+    if (bestQuery[j] >= 0) {
+      matchesInfo.matches.push_back(
+          DMatch(bestQuery[j], (int)j, bestDistance[j]));
+    }
+  }
+
+  this->comparisonStats.push_back(comparisons);
+  this->fractionStats.push_back(100.0 * comparisons /
+                                ((double)desc1.rows * desc2.rows));
+
+  estimateHomography(features1, features2, matchesInfo);
+}
+
+/**
+ * Get the descriptor comparisons per matched pair
+ */
+const Stats<double> &GuidedMatcher::getComparisonStats() const {
+  return this->comparisonStats;
+}
+
+/**
+ * Print the descriptor comparisons statistics
+ */
+void GuidedMatcher::printStats() {
+  cout << this->comparisonStats.str();
+  cout << this->fractionStats.str();
+}
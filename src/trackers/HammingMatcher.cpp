@@ -0,0 +1,140 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Pedro Cuadra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+#include <trackers/HammingMatcher.hpp>
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+#include <trackers/TileScan.hpp>
+#include <util/HammingDistance.hpp>
+
+/** Scan of the binary descriptors */
+template <class Collector>
+using HammingScan =
+    TileScanBody<uint8_t, HammingDistance::queryBlock, Collector>;
+
+/**
+ * Get the integer radius of a Hamming distance
+ */
+static int integerRadius(float maxDistance) {
+  if (maxDistance >= (float)INT_MAX) {
+    return INT_MAX;
+  }
+
+  return (int)floor(maxDistance);
+}
+
+/**
+ * Brute-force Hamming matcher
+ */
+HammingMatcher::HammingMatcher() {}
+
+bool HammingMatcher::isMaskSupported() const { return false; }
+
+Ptr<DescriptorMatcher> HammingMatcher::clone(bool emptyTrainData) const {
+  Ptr<HammingMatcher> matcher = makePtr<HammingMatcher>();
+
+  if (!emptyTrainData) {
+    for (int i = 0; i < this->trainCount(); i++) {
+      matcher->trainDescCollection.push_back(this->getTrain(i).clone());
+    }
+  }
+
+  return matcher;
+}
+
+Mat HammingMatcher::getTrain(int imgIdx) const {
+  if (!this->trainDescCollection.empty()) {
+    return this->trainDescCollection[imgIdx];
+  }
+
+  return this->utrainDescCollection[imgIdx].getMat(ACCESS_READ);
+}
+
+int HammingMatcher::trainCount() const {
+  return max(this->trainDescCollection.size(),
+             this->utrainDescCollection.size());
+}
+
+void HammingMatcher::knnMatchImpl(InputArray queryDescriptors,
+                                  vector<vector<DMatch>> &matches, int k,
+                                  InputArrayOfArrays, bool compactResult) {
+  Mat query = queryDescriptors.getMat();
+  vector<Mat> train;
+
+  matches.assign(query.rows, vector<DMatch>());
+
+  if (query.empty() || k <= 0) {
+    return;
+  }
+
+  CV_Assert(query.type() == CV_8U);
+
+  for (int i = 0; i < this->trainCount(); i++) {
+    train.push_back(this->getTrain(i));
+  }
+
+  TopKCollector<> collect(query.rows, k);
+  HammingScan<TopKCollector<>>::scan(
+      query, train, HammingDistance::select(query.cols), collect);
+  collect.getMatches(matches, [](int d) { return (float)d; });
+
+  if (compactResult) {
+    compactMatches(matches);
+  }
+}
+
+void HammingMatcher::radiusMatchImpl(InputArray queryDescriptors,
+                                     vector<vector<DMatch>> &matches,
+                                     float maxDistance, InputArrayOfArrays,
+                                     bool compactResult) {
+  Mat query = queryDescriptors.getMat();
+  vector<Mat> train;
+
+  matches.assign(query.rows, vector<DMatch>());
+
+  if (query.empty()) {
+    return;
+  }
+
+  CV_Assert(query.type() == CV_8U);
+
+  for (int i = 0; i < this->trainCount(); i++) {
+    train.push_back(this->getTrain(i));
+  }
+
+  RadiusCollector collect(matches, integerRadius(maxDistance));
+  HammingScan<RadiusCollector>::scan(
+      query, train, HammingDistance::select(query.cols), collect);
+
+  for (size_t q = 0; q < matches.size(); q++) {
+    sort(matches[q].begin(), matches[q].end());
+  }
+
+  if (compactResult) {
+    compactMatches(matches);
+  }
+}
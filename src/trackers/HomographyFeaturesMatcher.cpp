@@ -0,0 +1,182 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Pedro Cuadra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+#include <trackers/HomographyFeaturesMatcher.hpp>
+
+#include <cmath>
+#include <limits>
+#include <set>
+
+#include <opencv2/calib3d.hpp>
+
+/**
+ * Get the matched points of a pair, centered on their images
+ */
+static void centeredPoints(const ImageFeatures &features1,
+                           const ImageFeatures &features2,
+                           const MatchesInfo &matchesInfo, bool inliersOnly,
+                           Mat &srcPoints, Mat &dstPoints) {
+  int count = 0;
+
+  srcPoints.create(1, inliersOnly ? matchesInfo.num_inliers
+                                  : (int)matchesInfo.matches.size(),
+                   CV_32FC2);
+  dstPoints.create(1, srcPoints.cols, CV_32FC2);
+
+  for (size_t i = 0; i < matchesInfo.matches.size(); i++) {
+    const DMatch &m = matchesInfo.matches[i];
+    Point2f p1 = features1.keypoints[m.queryIdx].pt;
+    Point2f p2 = features2.keypoints[m.trainIdx].pt;
+
+    if (inliersOnly && !matchesInfo.inliers_mask[i]) {
+      continue;
+    }
+
+    p1.x -= features1.img_size.width * 0.5f;
+    p1.y -= features1.img_size.height * 0.5f;
+    p2.x -= features2.img_size.width * 0.5f;
+    p2.y -= features2.img_size.height * 0.5f;
+
+    srcPoints.at<Point2f>(0, count) = p1;
+    dstPoints.at<Point2f>(0, count) = p2;
+    count++;
+  }
+}
+
+/**
+ * Constructor
+ */
+HomographyFeaturesMatcher::HomographyFeaturesMatcher(bool isThreadSafe,
+                                                     int numMatchesThresh1,
+                                                     int numMatchesThresh2)
+    : FeaturesMatcher(isThreadSafe), numMatchesThresh1(numMatchesThresh1),
+      numMatchesThresh2(numMatchesThresh2) {}
+
+/**
+ * Convert a MatchesInfo homography into pixel coordinates
+ */
+Mat HomographyFeaturesMatcher::uncentered(const Mat &H, Size size1,
+                                          Size size2) {
+  Mat toCentered = Mat::eye(3, 3, CV_64F);
+  Mat fromCentered = Mat::eye(3, 3, CV_64F);
+
+  if (H.empty()) {
+    return Mat();
+  }
+
+  toCentered.at<double>(0, 2) = -size1.width * 0.5;
+  toCentered.at<double>(1, 2) = -size1.height * 0.5;
+  fromCentered.at<double>(0, 2) = size2.width * 0.5;
+  fromCentered.at<double>(1, 2) = size2.height * 0.5;
+
+  Mat h;
+  H.convertTo(h, CV_64F);
+
+  return fromCentered * h * toCentered;
+}
+
+/**
+ * Ratio test in both directions, as BestOf2NearestMatcher does
+ */
+void HomographyFeaturesMatcher::ratioTest(
+    const vector<vector<DMatch>> &forward,
+    const vector<vector<DMatch>> &backward, float matchConf, bool crossCheck,
+    MatchesInfo &matchesInfo) {
+  set<pair<int, int>> pairs;
+  float ratio = 1.f - matchConf;
+
+  for (size_t i = 0; i < forward.size(); i++) {
+    if (forward[i].size() < 2 ||
+        forward[i][0].distance >= ratio * forward[i][1].distance) {
+      continue;
+    }
+
+    const DMatch &m = forward[i][0];
+    const vector<DMatch> &reverse = backward[m.trainIdx];
+    bool mutual = !reverse.empty() && reverse[0].trainIdx == m.queryIdx;
+
+    if (crossCheck && !mutual) {
+      continue;
+    }
+
+    matchesInfo.matches.push_back(m);
+    pairs.insert(make_pair(m.queryIdx, m.trainIdx));
+  }
+
+  for (size_t i = 0; i < backward.size() && !crossCheck; i++) {
+    if (backward[i].size() < 2 ||
+        backward[i][0].distance >= ratio * backward[i][1].distance) {
+      continue;
+    }
+
+    const DMatch &m = backward[i][0];
+
+    if (pairs.find(make_pair(m.trainIdx, m.queryIdx)) == pairs.end()) {
+      matchesInfo.matches.push_back(DMatch(m.trainIdx, m.queryIdx, m.distance));
+    }
+  }
+}
+
+/**
+ * Estimate the homography, the same as BestOf2NearestMatcher
+ */
+void HomographyFeaturesMatcher::estimateHomography(
+    const ImageFeatures &features1, const ImageFeatures &features2,
+    MatchesInfo &matchesInfo) const {
+  Mat srcPoints, dstPoints, inliers;
+
+  if ((int)matchesInfo.matches.size() < this->numMatchesThresh1) {
+    return;
+  }
+
+  centeredPoints(features1, features2, matchesInfo, false, srcPoints,
+                 dstPoints);
+
+  matchesInfo.H = findHomography(srcPoints, dstPoints, inliers, RANSAC);
+
+  if (matchesInfo.H.empty() || std::abs(determinant(matchesInfo.H)) <
+                                   numeric_limits<double>::epsilon()) {
+    return;
+  }
+
+  matchesInfo.inliers_mask.assign(inliers.ptr<uchar>(),
+                                  inliers.ptr<uchar>() + inliers.total());
+  matchesInfo.num_inliers = countNonZero(inliers);
+
+  // Same confidence as BestOf2NearestMatcher, too close images score 0
+  matchesInfo.confidence =
+      matchesInfo.num_inliers / (8 + 0.3 * matchesInfo.matches.size());
+  matchesInfo.confidence =
+      matchesInfo.confidence > 3. ? 0. : matchesInfo.confidence;
+
+  if (matchesInfo.num_inliers < this->numMatchesThresh2) {
+    return;
+  }
+
+  // Refine the homography with the inliers only
+  centeredPoints(features1, features2, matchesInfo, true, srcPoints,
+                 dstPoints);
+
+  matchesInfo.H = findHomography(srcPoints, dstPoints, RANSAC);
+}
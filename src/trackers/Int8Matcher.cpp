@@ -0,0 +1,170 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Pedro Cuadra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+#include <trackers/Int8Matcher.hpp>
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+#include <trackers/TileScan.hpp>
+#include <util/Int8Distance.hpp>
+
+/** Scan of the quantized descriptors */
+template <class Collector>
+using Int8Scan = TileScanBody<int8_t, Int8Distance::queryBlock, Collector>;
+
+/**
+ * Brute-force L2 matcher for int8 quantized descriptors
+ */
+Int8Matcher::Int8Matcher(float scale) : scale(scale) {}
+
+bool Int8Matcher::isMaskSupported() const { return false; }
+
+Ptr<DescriptorMatcher> Int8Matcher::clone(bool emptyTrainData) const {
+  Ptr<Int8Matcher> matcher = makePtr<Int8Matcher>(this->scale);
+
+  if (!emptyTrainData) {
+    for (int i = 0; i < this->trainCount(); i++) {
+      matcher->trainDescCollection.push_back(this->getTrain(i).clone());
+    }
+  }
+
+  return matcher;
+}
+
+Mat Int8Matcher::getTrain(int imgIdx) const {
+  if (!this->trainDescCollection.empty()) {
+    return this->trainDescCollection[imgIdx];
+  }
+
+  return this->utrainDescCollection[imgIdx].getMat(ACCESS_READ);
+}
+
+int Int8Matcher::trainCount() const {
+  return max(this->trainDescCollection.size(),
+             this->utrainDescCollection.size());
+}
+
+void Int8Matcher::knnMatchImpl(InputArray queryDescriptors,
+                               vector<vector<DMatch>> &matches, int k,
+                               InputArrayOfArrays, bool compactResult) {
+  Mat query = queryDescriptors.getMat();
+  vector<Mat> train;
+  float scale = this->scale;
+
+  matches.assign(query.rows, vector<DMatch>());
+
+  if (query.empty() || k <= 0) {
+    return;
+  }
+
+  CV_Assert(query.type() == CV_8S);
+
+  for (int i = 0; i < this->trainCount(); i++) {
+    train.push_back(this->getTrain(i));
+  }
+
+  TopKCollector<> collect(query.rows, k);
+  Int8Scan<TopKCollector<>>::scan(query, train,
+                                Int8Distance::select(query.cols), collect);
+  collect.getMatches(matches,
+                     [scale](int d) { return scale * std::sqrt((float)d); });
+
+  if (compactResult) {
+    compactMatches(matches);
+  }
+}
+
+void Int8Matcher::radiusMatchImpl(InputArray queryDescriptors,
+                                  vector<vector<DMatch>> &matches,
+                                  float maxDistance, InputArrayOfArrays,
+                                  bool compactResult) {
+  Mat query = queryDescriptors.getMat();
+  vector<Mat> train;
+  // Squared distance in quantized units
+  double radius = (double)maxDistance / this->scale;
+  double radius2 = radius * radius;
+
+  matches.assign(query.rows, vector<DMatch>());
+
+  if (query.empty() || maxDistance < 0) {
+    return;
+  }
+
+  CV_Assert(query.type() == CV_8S);
+
+  for (int i = 0; i < this->trainCount(); i++) {
+    train.push_back(this->getTrain(i));
+  }
+
+  RadiusCollector collect(matches,
+                          radius2 >= INT_MAX ? INT_MAX : (int)floor(radius2));
+  Int8Scan<RadiusCollector>::scan(query, train,
+                                  Int8Distance::select(query.cols), collect);
+
+  for (size_t q = 0; q < matches.size(); q++) {
+    for (size_t i = 0; i < matches[q].size(); i++) {
+      matches[q][i].distance = this->scale * std::sqrt(matches[q][i].distance);
+    }
+
+    sort(matches[q].begin(), matches[q].end());
+  }
+
+  if (compactResult) {
+    compactMatches(matches);
+  }
+}
+
+/**
+ * Pairwise features matcher on top of Int8Matcher
+ */
+Int8FeaturesMatcher::Int8FeaturesMatcher(float matchConf, bool crossCheck,
+                                         int numMatchesThresh1,
+                                         int numMatchesThresh2)
+    : HomographyFeaturesMatcher(true, numMatchesThresh1, numMatchesThresh2),
+      matchConf(matchConf), crossCheck(crossCheck) {}
+
+void Int8FeaturesMatcher::match(const ImageFeatures &features1,
+                                const ImageFeatures &features2,
+                                MatchesInfo &matchesInfo) {
+  Mat desc1 = features1.descriptors.getMat(ACCESS_READ);
+  Mat desc2 = features2.descriptors.getMat(ACCESS_READ);
+  vector<vector<DMatch>> forward, backward;
+  Int8Matcher matcher;
+
+  matchesInfo.matches.clear();
+
+  if (desc1.empty() || desc2.empty()) {
+    return;
+  }
+
+  // The ratio test doesn't depend on the scale
+  matcher.knnMatch(desc1, desc2, forward, 2);
+  matcher.knnMatch(desc2, desc1, backward, 2);
+
+  ratioTest(forward, backward, this->matchConf, this->crossCheck,
+            matchesInfo);
+  estimateHomography(features1, features2, matchesInfo);
+}
@@ -0,0 +1,227 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Pedro Cuadra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+#include <trackers/KltTracker.hpp>
+
+#include <opencv2/imgproc/imgproc.hpp>
+#include <opencv2/video/tracking.hpp>
+
+#include <util/KeyPointGrid.hpp>
+#include <util/Log.hpp>
+
+/**
+ * Constructor
+ */
+KltTracker::KltTracker(CommandLineParser parser, string name,
+                       Ptr<Feature2D> detector, const Params &params)
+    : Tracker(parser, name, detector), params(params),
+      pyramidBuildStats(name + " - Pyramid Builds", ""),
+      pyramidReuseStats(name + " - Pyramid Reuses", ""),
+      liveStats(name + " - Live Tracks", ""),
+      detectedStats(name + " - Keypoints Detected", "") {
+  // Tracked points carry over to the next pair
+  this->setSequential(true);
+}
+
+/**
+ * Prepare the gray images and detect the missing tracks
+ */
+void KltTracker::runExtract() {
+  LOG_FUNCTION(__PRETTY_FUNCTION__);
+
+  // Reused features mean the frame id came back, and so do its gray image
+  // and pyramid. Looked up before replacing the previous second frame.
+  Ptr<Frame> first = this->extracted[0] ? this->frames[1]
+                                        : makePtr<Frame>(this->inputImage[0]);
+  Ptr<Frame> second = this->extracted[1] ? this->frames[1]
+                                         : makePtr<Frame>(this->inputImage[1]);
+
+  this->frames[0] = first;
+  this->frames[1] = second;
+
+  for (int i = 0; i < 2; i++) {
+    this->gray[i] = this->frames[i]->getGray();
+  }
+
+  // Without carried over tracks the first image starts from scratch
+  if (!this->extracted[0]) {
+    this->keypoints[0].clear();
+  }
+
+  if (this->tracksSuffice()) {
+    this->detectedStats.push_back(0);
+  } else {
+    this->detectTracks();
+  }
+
+  this->extracted[0] = true;
+}
+
+/**
+ * Track the first image keypoints with a forward-backward check
+ */
+void KltTracker::runTrack() {
+  LOG_FUNCTION(__PRETTY_FUNCTION__);
+  const vector<Mat> *pyramid[2];
+  int builds = 0, reuses = 0;
+  vector<Point2f> points, tracked, back;
+  vector<uchar> status, backStatus;
+  vector<float> error;
+  Rect2f bounds(Point2f(0, 0), Size2f(this->gray[1].size()));
+
+  this->keypoints[1].clear();
+  this->descriptors[1].release();
+  this->matches.clear();
+  this->knnMatches.clear();
+  this->reverseKnnMatches.clear();
+  this->extracted[1] = true;
+
+  if (this->keypoints[0].empty()) {
+    this->liveStats.push_back(0);
+    return;
+  }
+
+  // Both directions share the same pyramids, and the second one is the
+  // first of the next pair
+  for (int i = 0; i < 2; i++) {
+    size_t before = this->frames[i]->getBuilds();
+
+    pyramid[i] = &this->frames[i]->getFlowPyramid(this->params.winSize,
+                                                  this->params.maxLevel);
+
+    if (this->frames[i]->getBuilds() != before) {
+      builds++;
+    } else {
+      reuses++;
+    }
+  }
+
+  this->pyramidBuildStats.push_back(builds);
+  this->pyramidReuseStats.push_back(reuses);
+
+  KeyPoint::convert(this->keypoints[0], points);
+
+  calcOpticalFlowPyrLK(*pyramid[0], *pyramid[1], points, tracked, status,
+                       error, this->params.winSize, this->params.maxLevel);
+  calcOpticalFlowPyrLK(*pyramid[1], *pyramid[0], tracked, back, backStatus,
+                       error, this->params.winSize, this->params.maxLevel);
+
+  for (size_t i = 0; i < points.size(); i++) {
+    float fbError = (float)norm(back[i] - points[i]);
+
+    if (!status[i] || !backStatus[i] || fbError > this->params.maxFbError ||
+        !bounds.contains(tracked[i])) {
+      continue;
+    }
+
+    KeyPoint keypoint = this->keypoints[0][i];
+    keypoint.pt = tracked[i];
+
+    this->matches.push_back(
+        DMatch((int)i, (int)this->keypoints[1].size(), fbError));
+    this->keypoints[1].push_back(keypoint);
+  }
+
+  this->liveStats.push_back((int)this->matches.size());
+
+  LOG_DEBUG("Live tracks " << this->matches.size() << " of "
+                           << points.size());
+}
+
+/**
+ * The forward-backward check already filtered the tracks
+ */
+void KltTracker::runFilter() { LOG_FUNCTION(__PRETTY_FUNCTION__); }
+
+/**
+ * Track every consecutive pair of a sequence of frames, not pipelined
+ */
+void KltTracker::trackSequence(FrameSource source, PairSink sink,
+                               size_t depth) {
+  Tracker::trackSequence(source, sink, 0);
+}
+
+/**
+ * Print the tracker statistics
+ */
+void KltTracker::printStats() {
+  Tracker::printStats();
+
+  cout << this->liveStats.str();
+  cout << this->detectedStats.str();
+  cout << this->pyramidBuildStats.str();
+  cout << this->pyramidReuseStats.str();
+}
+
+/**
+ * Check whether the live tracks still cover the first image
+ */
+bool KltTracker::tracksSuffice() const {
+  Size size = this->gray[0].size();
+  float cellSize = (float)max(size.width, size.height) /
+                   this->params.coverageCells;
+  KeyPointGrid grid(cellSize);
+  int covered = 0;
+
+  if ((int)this->keypoints[0].size() < this->params.minTracks) {
+    return false;
+  }
+
+  grid.build(this->keypoints[0], size);
+
+  for (int y = 0; y < grid.getCells().height; y++) {
+    for (int x = 0; x < grid.getCells().width; x++) {
+      covered += grid.count(x, y) > 0 ? 1 : 0;
+    }
+  }
+
+  return covered >= this->params.minCoverage * grid.getCells().area();
+}
+
+/**
+ * Detect keypoints away from the live tracks until maxTracks
+ */
+void KltTracker::detectTracks() {
+  LOG_FUNCTION(__PRETTY_FUNCTION__);
+  int budget = this->params.maxTracks - (int)this->keypoints[0].size();
+  Mat mask(this->gray[0].size(), CV_8U, Scalar(255));
+  vector<KeyPoint> found;
+
+  if (budget <= 0) {
+    this->detectedStats.push_back(0);
+    return;
+  }
+
+  for (size_t i = 0; i < this->keypoints[0].size(); i++) {
+    circle(mask, this->keypoints[0][i].pt, this->params.minDistance,
+           Scalar(0), -1);
+  }
+
+  this->detector->detect(this->gray[0], found, mask);
+  KeyPointsFilter::retainBest(found, budget);
+
+  this->keypoints[0].insert(this->keypoints[0].end(), found.begin(),
+                            found.end());
+  this->detectedStats.push_back((int)found.size());
+}
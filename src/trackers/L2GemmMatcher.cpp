@@ -0,0 +1,231 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Pedro Cuadra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+#include <trackers/L2GemmMatcher.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+#include <trackers/TileScan.hpp>
+
+/** Descriptors per block side of the distance matrix */
+static const int blockRows = 256;
+
+/**
+ * Distance of a match from its squared distance
+ * @param d Squared distance
+ * @return distance
+ */
+static float squaredToDistance(float d) { return sqrt(d); }
+
+/**
+ * Visit every squared distance between two descriptor sets, one block of
+ * the distance matrix at a time
+ * @param query Query descriptors
+ * @param train Train descriptors
+ * @param visit Called with the query index, train index and squared distance
+ */
+template <class Visitor>
+static void scanDistances(const Mat &query, const Mat &train, Visitor visit) {
+  Mat queryNorms, trainNorms, block;
+
+  CV_Assert(query.type() == CV_32F && train.type() == CV_32F &&
+            query.cols == train.cols);
+
+  reduce(query.mul(query), queryNorms, 1, REDUCE_SUM);
+  reduce(train.mul(train), trainNorms, 1, REDUCE_SUM);
+
+  for (int q0 = 0; q0 < query.rows; q0 += blockRows) {
+    Range qr(q0, min(q0 + blockRows, query.rows));
+
+    for (int t0 = 0; t0 < train.rows; t0 += blockRows) {
+      Range tr(t0, min(t0 + blockRows, train.rows));
+
+      // -2 a·b for the whole block, the norms are added on the fly
+      gemm(query.rowRange(qr), train.rowRange(tr), -2.0, noArray(), 0, block,
+           GEMM_2_T);
+
+      for (int q = qr.start; q < qr.end; q++) {
+        const float *row = block.ptr<float>(q - q0);
+        float qn = queryNorms.at<float>(q);
+
+        for (int t = tr.start; t < tr.end; t++) {
+          // Rounding can push the distance of close pairs below zero
+          visit(q, t, max(0.f, row[t - t0] + qn + trainNorms.at<float>(t)));
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Brute-force L2 matcher
+ */
+L2GemmMatcher::L2GemmMatcher() {}
+
+bool L2GemmMatcher::isMaskSupported() const { return false; }
+
+Ptr<DescriptorMatcher> L2GemmMatcher::clone(bool emptyTrainData) const {
+  Ptr<L2GemmMatcher> matcher = makePtr<L2GemmMatcher>();
+
+  if (!emptyTrainData) {
+    for (int i = 0; i < this->trainCount(); i++) {
+      matcher->trainDescCollection.push_back(this->getTrain(i).clone());
+    }
+  }
+
+  return matcher;
+}
+
+Mat L2GemmMatcher::getTrain(int imgIdx) const {
+  if (!this->trainDescCollection.empty()) {
+    return this->trainDescCollection[imgIdx];
+  }
+
+  return this->utrainDescCollection[imgIdx].getMat(ACCESS_READ);
+}
+
+int L2GemmMatcher::trainCount() const {
+  return max(this->trainDescCollection.size(),
+             this->utrainDescCollection.size());
+}
+
+void L2GemmMatcher::knnMatch2Way(const Mat &query, const Mat &train,
+                                 vector<vector<DMatch>> &forward,
+                                 vector<vector<DMatch>> &backward) const {
+  TopKCollector<float> rows(query.rows, 2), cols(train.rows, 2);
+
+  forward.assign(query.rows, vector<DMatch>());
+  backward.assign(train.rows, vector<DMatch>());
+
+  if (query.empty() || train.empty()) {
+    return;
+  }
+
+  scanDistances(query, train, [&rows, &cols](int q, int t, float d) {
+    rows(q, 0, t, d);
+    cols(t, 0, q, d);
+  });
+
+  rows.getMatches(forward, squaredToDistance);
+  cols.getMatches(backward, squaredToDistance);
+}
+
+void L2GemmMatcher::knnMatchImpl(InputArray queryDescriptors,
+                                 vector<vector<DMatch>> &matches, int k,
+                                 InputArrayOfArrays, bool compactResult) {
+  Mat query = queryDescriptors.getMat();
+
+  matches.assign(query.rows, vector<DMatch>());
+
+  if (query.empty() || k <= 0) {
+    return;
+  }
+
+  TopKCollector<float> rows(query.rows, k);
+
+  for (int img = 0; img < this->trainCount(); img++) {
+    Mat train = this->getTrain(img);
+
+    if (train.empty()) {
+      continue;
+    }
+
+    scanDistances(query, train, [&rows, img](int q, int t, float d) {
+      rows(q, img, t, d);
+    });
+  }
+
+  rows.getMatches(matches, squaredToDistance);
+
+  if (compactResult) {
+    compactMatches(matches);
+  }
+}
+
+void L2GemmMatcher::radiusMatchImpl(InputArray queryDescriptors,
+                                    vector<vector<DMatch>> &matches,
+                                    float maxDistance, InputArrayOfArrays,
+                                    bool compactResult) {
+  Mat query = queryDescriptors.getMat();
+  float maxSquared = maxDistance * maxDistance;
+
+  matches.assign(query.rows, vector<DMatch>());
+
+  if (query.empty()) {
+    return;
+  }
+
+  for (int img = 0; img < this->trainCount(); img++) {
+    Mat train = this->getTrain(img);
+
+    if (train.empty()) {
+      continue;
+    }
+
+    scanDistances(query, train,
+                  [&matches, maxSquared, img](int q, int t, float d) {
+                    if (d <= maxSquared) {
+                      matches[q].push_back(DMatch(q, t, img, sqrt(d)));
+                    }
+                  });
+  }
+
+  for (size_t q = 0; q < matches.size(); q++) {
+    sort(matches[q].begin(), matches[q].end());
+  }
+
+  if (compactResult) {
+    compactMatches(matches);
+  }
+}
+
+/**
+ * Pairwise features matcher on top of L2GemmMatcher
+ */
+GemmFeaturesMatcher::GemmFeaturesMatcher(float matchConf, bool crossCheck,
+                                         int numMatchesThresh1,
+                                         int numMatchesThresh2)
+    : HomographyFeaturesMatcher(true, numMatchesThresh1, numMatchesThresh2),
+      matchConf(matchConf), crossCheck(crossCheck) {}
+
+void GemmFeaturesMatcher::match(const ImageFeatures &features1,
+                                const ImageFeatures &features2,
+                                MatchesInfo &matchesInfo) {
+  Mat desc1 = features1.descriptors.getMat(ACCESS_READ);
+  Mat desc2 = features2.descriptors.getMat(ACCESS_READ);
+  vector<vector<DMatch>> forward, backward;
+
+  matchesInfo.matches.clear();
+
+  if (desc1.empty() || desc2.empty()) {
+    return;
+  }
+
+  this->matcher.knnMatch2Way(desc1, desc2, forward, backward);
+
+  ratioTest(forward, backward, this->matchConf, this->crossCheck,
+            matchesInfo);
+  estimateHomography(features1, features2, matchesInfo);
+}
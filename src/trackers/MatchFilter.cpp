@@ -0,0 +1,251 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Pedro Cuadra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+#include <trackers/MatchFilter.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+#include <util/Timing.hpp>
+#include <util/Trace.hpp>
+
+/**
+ * Keep the matches satisfying a predicate, preserving their order
+ * @param matches Matches to be filtered
+ * @param keep    Predicate
+ */
+template <class Predicate>
+static void retain(vector<DMatch> &matches, Predicate keep) {
+  matches.erase(remove_if(matches.begin(), matches.end(),
+                          [&keep](const DMatch &m) { return !keep(m); }),
+                matches.end());
+}
+
+/**
+ * Match filter
+ */
+MatchFilter::MatchFilter(string name)
+    : name(name), timingStats(name + " - Timing", "s"),
+      survivorsStats(name + " - Survivors", "") {}
+
+/**
+ * Filter the matches in place
+ */
+void MatchFilter::filter(const MatchContext &context, vector<DMatch> &matches) {
+  TRACE_SPAN(this->name, "filter");
+  Timing timing;
+
+  timing.start();
+  this->run(context, matches);
+  timing.end();
+
+  this->timingStats.push_back(timing.getDelta());
+  this->survivorsStats.push_back(matches.size());
+}
+
+/**
+ * Get the name of the filter
+ */
+string MatchFilter::getName() const { return this->name; }
+
+/**
+ * Get the nearest neighbours of every query the filter needs
+ */
+int MatchFilter::getNeighbours() const { return 1; }
+
+/**
+ * Print the cost and survivors statistics
+ */
+void MatchFilter::printStats() {
+  cout << this->timingStats.str();
+  cout << this->survivorsStats.str();
+}
+
+/**
+ * Lowe's ratio test
+ */
+RatioTestFilter::RatioTestFilter(double ratio)
+    : MatchFilter("Ratio Test"), ratio(ratio) {}
+
+int RatioTestFilter::getNeighbours() const { return 2; }
+
+void RatioTestFilter::run(const MatchContext &context,
+                          vector<DMatch> &matches) {
+  const vector<vector<DMatch>> &knn = *context.knnMatches;
+  double ratio = this->ratio;
+
+  retain(matches, [&knn, ratio](const DMatch &m) {
+    const vector<DMatch> &neighbours = knn[m.queryIdx];
+
+    // Without a runner-up there's nothing to compare against
+    return neighbours.size() < 2 ||
+           m.distance < ratio * neighbours[1].distance;
+  });
+}
+
+/**
+ * Symmetric cross-check
+ */
+CrossCheckFilter::CrossCheckFilter() : MatchFilter("Cross Check") {}
+
+void CrossCheckFilter::run(const MatchContext &context,
+                           vector<DMatch> &matches) {
+  const vector<DMatch> &reverse = this->reverse;
+
+  if (context.reverseKnnMatches) {
+    const vector<vector<DMatch>> &knn = *context.reverseKnnMatches;
+
+    // Already computed along with the forward matches
+    retain(matches, [&knn](const DMatch &m) {
+      return m.trainIdx < (int)knn.size() && !knn[m.trainIdx].empty() &&
+             knn[m.trainIdx][0].trainIdx == m.queryIdx;
+    });
+    return;
+  }
+
+  context.matcher->match(*context.descriptors[1], *context.descriptors[0],
+                         this->reverse);
+
+  retain(matches, [&reverse](const DMatch &m) {
+    return m.trainIdx < (int)reverse.size() &&
+           reverse[m.trainIdx].trainIdx == m.queryIdx;
+  });
+}
+
+/**
+ * Normalized distance threshold
+ */
+DistanceFilter::DistanceFilter(double threshold)
+    : MatchFilter("Distance"), threshold(threshold) {}
+
+void DistanceFilter::setThreshold(double threshold) {
+  this->threshold = threshold;
+}
+
+void DistanceFilter::run(const MatchContext &, vector<DMatch> &matches) {
+  double minDist, maxDist, cut;
+
+  if (matches.empty()) {
+    return;
+  }
+
+  // A single linear pass, no need to order the matches
+  auto range = minmax_element(matches.begin(), matches.end(),
+                              [](const DMatch &a, const DMatch &b) {
+                                return a.distance < b.distance;
+                              });
+  minDist = range.first->distance;
+  maxDist = range.second->distance;
+  cut = minDist + this->threshold * (maxDist - minDist);
+
+  retain(matches, [cut](const DMatch &m) { return m.distance <= cut; });
+}
+
+/**
+ * Grid-based motion statistics filter
+ */
+GridMotionFilter::GridMotionFilter(int gridSize, double alpha)
+    : MatchFilter("Grid Motion"), gridSize(max(1, gridSize)), alpha(alpha) {}
+
+int GridMotionFilter::cellOf(Point2f pt, Size size) const {
+  int x = (int)(pt.x * this->gridSize / max(1, size.width));
+  int y = (int)(pt.y * this->gridSize / max(1, size.height));
+
+  x = min(max(x, 0), this->gridSize - 1);
+  y = min(max(y, 0), this->gridSize - 1);
+
+  return y * this->gridSize + x;
+}
+
+void GridMotionFilter::run(const MatchContext &context,
+                           vector<DMatch> &matches) {
+  const vector<KeyPoint> &kp0 = *context.keypoints[0];
+  const vector<KeyPoint> &kp1 = *context.keypoints[1];
+  int g = this->gridSize;
+  int cells = g * g;
+  vector<int> dominant(cells, -1), features(cells, 0);
+  vector<char> consistent(cells, 0);
+  vector<int> cell0(matches.size()), cell1(matches.size());
+
+  this->pairCount.assign(cells * cells, 0);
+
+  for (size_t i = 0; i < kp0.size(); i++) {
+    features[cellOf(kp0[i].pt, context.imageSize[0])]++;
+  }
+
+  for (size_t i = 0; i < matches.size(); i++) {
+    cell0[i] = cellOf(kp0[matches[i].queryIdx].pt, context.imageSize[0]);
+    cell1[i] = cellOf(kp1[matches[i].trainIdx].pt, context.imageSize[1]);
+    this->pairCount[cell0[i] * cells + cell1[i]]++;
+  }
+
+  // Each query cell moves as a whole to its most voted cell
+  for (int c = 0; c < cells; c++) {
+    const int *row = &this->pairCount[c * cells];
+    int best = max_element(row, row + cells) - row;
+
+    dominant[c] = row[best] > 0 ? best : -1;
+  }
+
+  // Support of the motion from the 3x3 neighbourhood moving the same way
+  for (int c = 0; c < cells; c++) {
+    int cx = c % g, cy = c / g;
+    int neighbourFeatures = 0, votes = 0;
+
+    if (dominant[c] < 0) {
+      continue;
+    }
+
+    for (int dy = -1; dy <= 1; dy++) {
+      for (int dx = -1; dx <= 1; dx++) {
+        int nx0 = cx + dx, ny0 = cy + dy;
+        int nx1 = dominant[c] % g + dx, ny1 = dominant[c] / g + dy;
+
+        if (nx0 < 0 || ny0 < 0 || nx0 >= g || ny0 >= g) {
+          continue;
+        }
+
+        neighbourFeatures += features[ny0 * g + nx0];
+
+        if (nx1 < 0 || ny1 < 0 || nx1 >= g || ny1 >= g) {
+          continue;
+        }
+
+        votes += this->pairCount[(ny0 * g + nx0) * cells + ny1 * g + nx1];
+      }
+    }
+
+    consistent[c] = votes > this->alpha * sqrt(neighbourFeatures / 9.0);
+  }
+
+  size_t kept = 0;
+
+  for (size_t i = 0; i < matches.size(); i++) {
+    if (dominant[cell0[i]] == cell1[i] && consistent[cell0[i]]) {
+      matches[kept++] = matches[i];
+    }
+  }
+
+  matches.resize(kept);
+}
@@ -0,0 +1,130 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Pedro Cuadra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+#include <trackers/ParallelFeaturesFinder.hpp>
+
+#include <exception>
+#include <mutex>
+
+#include <util/Log.hpp>
+#include <util/ThreadPool.hpp>
+#include <util/Timing.hpp>
+#include <util/Trace.hpp>
+
+/**
+ * Constructor
+ */
+ParallelFeaturesFinder::ParallelFeaturesFinder(FinderFactory factory,
+                                               int threads)
+    : factory(factory), threads(threads < 1 ? 1 : threads),
+      readStats("Features Finder - Image Read", "s"),
+      extractStats("Features Finder - Extraction", "s") {}
+
+/**
+ * Read and extract the features of every image
+ */
+void ParallelFeaturesFinder::operator()(ImageReader read,
+                                        vector<ImageFeatures> &features) {
+  LOG_FUNCTION(__PRETTY_FUNCTION__);
+  atomic<int> next(0);
+  // Per worker timings, merged once all of them are done
+  vector<Stats<double>> readTimes(this->threads, Stats<double>("", ""));
+  vector<Stats<double>> extractTimes(this->threads, Stats<double>("", ""));
+  exception_ptr failure;
+  mutex failureLock;
+
+  if (this->threads == 1) {
+    this->work(read, next, features, readTimes[0], extractTimes[0]);
+  } else {
+    ThreadPool workers(this->threads);
+
+    for (int w = 0; w < this->threads; w++) {
+      workers.push([this, w, &read, &next, &features, &readTimes,
+                    &extractTimes, &failure, &failureLock] {
+        try {
+          this->work(read, next, features, readTimes[w], extractTimes[w]);
+        } catch (...) {
+          lock_guard<mutex> guard(failureLock);
+          failure = current_exception();
+          // Stop the other workers too
+          next = (int)features.size();
+        }
+      });
+    }
+
+    workers.wait();
+  }
+
+  for (int w = 0; w < this->threads; w++) {
+    this->readStats.merge(readTimes[w]);
+    this->extractStats.merge(extractTimes[w]);
+  }
+
+  if (failure) {
+    rethrow_exception(failure);
+  }
+}
+
+/**
+ * Get the number of workers
+ */
+int ParallelFeaturesFinder::getThreads() const { return this->threads; }
+
+/**
+ * Print the per image timings
+ */
+void ParallelFeaturesFinder::printStats() {
+  cout << this->readStats.str();
+  cout << this->extractStats.str();
+}
+
+/**
+ * Worker loop
+ */
+void ParallelFeaturesFinder::work(ImageReader read, atomic<int> &next,
+                                  vector<ImageFeatures> &features,
+                                  Stats<double> &readTimes,
+                                  Stats<double> &extractTimes) {
+  Ptr<FeaturesFinder> finder = this->factory();
+  Timing timing;
+  Mat image;
+
+  for (int i = next++; i < (int)features.size(); i = next++) {
+    timing.start();
+    read(i, image);
+    timing.end();
+    readTimes.push_back(timing.getDelta());
+
+    {
+      TRACE_SPAN("findFeatures", "extract");
+      timing.start();
+      (*finder)(image, features[i]);
+      features[i].img_idx = i;
+      timing.end();
+      extractTimes.push_back(timing.getDelta());
+    }
+  }
+
+  finder->collectGarbage();
+}
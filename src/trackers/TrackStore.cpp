@@ -0,0 +1,244 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Pedro Cuadra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+#include <trackers/TrackStore.hpp>
+
+#include <algorithm>
+
+/**
+ * Constructor
+ */
+TrackStore::TrackStore(size_t capacity)
+    : nextObservation(0), nextId(0), frames(0),
+      lengthStats("Track Store - Retired Track Length", " frames"),
+      activeStats("Track Store - Live Tracks", "") {
+  size_t size = 2;
+
+  while (size < capacity) {
+    size <<= 1;
+  }
+
+  this->mask = size - 1;
+  this->observations.frame.resize(size);
+  this->observations.keypoint.resize(size);
+  this->observations.x.resize(size);
+  this->observations.y.resize(size);
+  this->observations.previous.resize(size);
+}
+
+/**
+ * Add the next frame
+ */
+int TrackStore::addFrame(const vector<KeyPoint> &keypoints,
+                         const vector<DMatch> &matches) {
+  int frame = this->frames;
+  vector<int> slots(keypoints.size(), -1);
+
+  // Tracks retired by the previous frame are no longer reachable
+  for (size_t i = 0; i < this->retiredSlots.size(); i++) {
+    int slot = this->retiredSlots[i];
+
+    this->slotOf.erase(this->tracks.id[slot]);
+    this->freeSlots.push_back(slot);
+  }
+
+  this->retiredSlots.clear();
+
+  for (size_t i = 0; i < matches.size() && frame > 0; i++) {
+    const DMatch &m = matches[i];
+
+    CV_Assert(m.queryIdx >= 0 && m.queryIdx < (int)this->lastPoints.size());
+    CV_Assert(m.trainIdx >= 0 && m.trainIdx < (int)keypoints.size());
+
+    int slot = this->keypointSlot[m.queryIdx];
+
+    // A track only continues through one keypoint per frame
+    if (slots[m.trainIdx] >= 0 ||
+        (slot >= 0 && this->tracks.lastFrame[slot] == frame)) {
+      continue;
+    }
+
+    if (slot < 0) {
+      slot = this->startTrack(m.queryIdx);
+    }
+
+    this->observe(slot, frame, m.trainIdx, keypoints[m.trainIdx].pt);
+    slots[m.trainIdx] = slot;
+  }
+
+  for (size_t i = 0; i < this->activeSlots.size(); i++) {
+    int slot = this->activeSlots[i];
+
+    if (this->tracks.lastFrame[slot] != frame) {
+      this->retiredSlots.push_back(slot);
+      this->lengthStats.push_back(this->tracks.length[slot]);
+    }
+  }
+
+  this->activeSlots.clear();
+  this->lastPoints.resize(keypoints.size());
+
+  for (size_t i = 0; i < keypoints.size(); i++) {
+    if (slots[i] >= 0) {
+      this->activeSlots.push_back(slots[i]);
+    }
+
+    this->lastPoints[i] = keypoints[i].pt;
+  }
+
+  this->keypointSlot.swap(slots);
+  this->activeStats.push_back((int)this->activeSlots.size());
+  this->frames++;
+
+  return frame;
+}
+
+/**
+ * Get the track of a keypoint of the last frame
+ */
+int64_t TrackStore::trackOf(int keypoint) const {
+  CV_Assert(keypoint >= 0 && keypoint < (int)this->keypointSlot.size());
+
+  int slot = this->keypointSlot[keypoint];
+
+  return slot < 0 ? -1 : this->tracks.id[slot];
+}
+
+/**
+ * Get the tracks extended by the last frame
+ */
+void TrackStore::activeTracks(vector<int64_t> &ids) const {
+  ids.clear();
+
+  for (size_t i = 0; i < this->activeSlots.size(); i++) {
+    ids.push_back(this->tracks.id[this->activeSlots[i]]);
+  }
+}
+
+/**
+ * Get the tracks that died with the last frame
+ */
+void TrackStore::retiredTracks(vector<int64_t> &ids) const {
+  ids.clear();
+
+  for (size_t i = 0; i < this->retiredSlots.size(); i++) {
+    ids.push_back(this->tracks.id[this->retiredSlots[i]]);
+  }
+}
+
+/**
+ * Get the observations of a track still in the buffers
+ */
+bool TrackStore::getTrack(int64_t id, vector<int> &frames,
+                          vector<int> &keypoints,
+                          vector<Point2f> &points) const {
+  unordered_map<int64_t, int>::const_iterator it = this->slotOf.find(id);
+  // Older observations were overwritten
+  int64_t oldest = this->nextObservation - (int64_t)(this->mask + 1);
+
+  frames.clear();
+  keypoints.clear();
+  points.clear();
+
+  if (it == this->slotOf.end()) {
+    return false;
+  }
+
+  for (int64_t seq = this->tracks.lastObservation[it->second];
+       seq >= 0 && seq >= oldest;) {
+    size_t i = (size_t)seq & this->mask;
+
+    frames.push_back(this->observations.frame[i]);
+    keypoints.push_back(this->observations.keypoint[i]);
+    points.push_back(Point2f(this->observations.x[i], this->observations.y[i]));
+    seq = this->observations.previous[i];
+  }
+
+  reverse(frames.begin(), frames.end());
+  reverse(keypoints.begin(), keypoints.end());
+  reverse(points.begin(), points.end());
+
+  return true;
+}
+
+/**
+ * Get the number of frames added
+ */
+int TrackStore::frameCount() const { return this->frames; }
+
+/**
+ * Print the tracks statistics
+ */
+void TrackStore::printStats() {
+  cout << this->activeStats.str();
+  cout << this->lengthStats.str();
+}
+
+/**
+ * Start a track at a keypoint of the last frame
+ */
+int TrackStore::startTrack(int keypoint) {
+  int slot;
+
+  if (this->freeSlots.empty()) {
+    slot = (int)this->tracks.id.size();
+    this->tracks.id.push_back(0);
+    this->tracks.firstFrame.push_back(0);
+    this->tracks.lastFrame.push_back(0);
+    this->tracks.length.push_back(0);
+    this->tracks.lastObservation.push_back(-1);
+  } else {
+    slot = this->freeSlots.back();
+    this->freeSlots.pop_back();
+  }
+
+  this->tracks.id[slot] = this->nextId++;
+  this->tracks.firstFrame[slot] = this->frames - 1;
+  this->tracks.length[slot] = 0;
+  this->tracks.lastObservation[slot] = -1;
+  this->slotOf[this->tracks.id[slot]] = slot;
+  this->keypointSlot[keypoint] = slot;
+
+  this->observe(slot, this->frames - 1, keypoint, this->lastPoints[keypoint]);
+
+  return slot;
+}
+
+/**
+ * Append an observation to a track
+ */
+void TrackStore::observe(int slot, int frame, int keypoint, Point2f point) {
+  int64_t seq = this->nextObservation++;
+  size_t i = (size_t)seq & this->mask;
+
+  this->observations.frame[i] = frame;
+  this->observations.keypoint[i] = keypoint;
+  this->observations.x[i] = point.x;
+  this->observations.y[i] = point.y;
+  this->observations.previous[i] = this->tracks.lastObservation[slot];
+
+  this->tracks.lastObservation[slot] = seq;
+  this->tracks.lastFrame[slot] = frame;
+  this->tracks.length[slot]++;
+}
@@ -24,108 +24,242 @@
  */
 #include <trackers/Tracker.hpp>
 
-#include <util/Debug.hpp>
+#include <exception>
+#include <thread>
+
+#include <trackers/AnnMatcher.hpp>
+#include <trackers/L2GemmMatcher.hpp>
+#include <util/BoundedQueue.hpp>
+#include <util/Log.hpp>
+#include <util/Timing.hpp>
+#include <util/Trace.hpp>
 
 using namespace cv::xfeatures2d;
 using namespace std;
 
 static const double gth = 0.3;
 
-Tracker::Tracker(CommandLineParser parser, string name) {
-  this->showEnable = parser.has("show");
-  this->name = name;
+/**
+ * Frame travelling through the sequence pipeline
+ */
+struct SequenceFrame {
+  Mat image;
+  vector<KeyPoint> keypoints;
+  Mat descriptors;
+};
 
-  this->goodTh = gth;
+/**
+ * Reads the settings BFMatcher keeps protected
+ */
+struct BFMatcherSettings : public BFMatcher {
+  static bool crossCheckOf(const BFMatcher &matcher) {
+    return matcher.*(&BFMatcherSettings::crossCheck);
+  }
+
+  static int normTypeOf(const BFMatcher &matcher) {
+    return matcher.*(&BFMatcherSettings::normType);
+  }
+};
+
+/**
+ * Pipeline stage statistics
+ */
+Tracker::StageStats::StageStats(const string &name)
+    : name(name), busy(name + " - Busy", "s"), wait(name + " - Blocked", "s"),
+      queued(name + " - Queued Frames", "") {}
+
+void Tracker::StageStats::print() {
+  double busyTime = this->busy.mean() * this->busy.size();
+  double waitTime = this->wait.mean() * this->wait.size();
+
+  if (this->busy.size() == 0) {
+    return;
+  }
+
+  cout << this->busy.str();
+  cout << this->wait.str();
+  cout << this->queued.str();
+  cout << this->name << " - Occupancy: "
+       << 100.0 * busyTime / (busyTime + waitTime) << "%" << endl;
 }
 
-Tracker::Tracker(CommandLineParser parser, string name, Ptr<Feature2D> detector)
-    : detector(detector) {
+Tracker::Tracker(CommandLineParser parser, string name)
+    : reuseStats(name + " - Extractions Reused", "") {
   this->showEnable = parser.has("show");
   this->name = name;
+  this->sequential = false;
+  this->referenceKept = false;
+  this->crossCheck = false;
+  this->extracted[0] = this->extracted[1] = false;
+  this->frameId[0] = this->frameId[1] = -1;
 
   this->goodTh = gth;
+  this->distanceFilter = makePtr<DistanceFilter>(gth);
+
+  this->stageStats.push_back(StageStats(name + " - Read Stage"));
+  this->stageStats.push_back(StageStats(name + " - Extract Stage"));
+  this->stageStats.push_back(StageStats(name + " - Match Stage"));
+}
+
+Tracker::Tracker(CommandLineParser parser, string name, Ptr<Feature2D> detector)
+    : Tracker(parser, name) {
+  this->detector = detector;
 }
 
 Tracker::Tracker(CommandLineParser parser, string name, Ptr<Feature2D> detector,
                  Ptr<DescriptorMatcher> matcher)
-    : detector(detector), matcher(matcher) {
-  this->showEnable = parser.has("show");
-  this->name = name;
+    : Tracker(parser, name) {
+  Ptr<BFMatcher> bf = matcher.dynamicCast<BFMatcher>();
+
+  this->detector = detector;
+  this->matcher = matcher;
+  this->knnMatcher = matcher;
+
+  // Cross-checking only supports a single neighbour, the runner-up comes
+  // from a plain copy and the cross-check is applied on the k-NN results
+  if (bf && BFMatcherSettings::crossCheckOf(*bf)) {
+    this->knnMatcher =
+        makePtr<BFMatcher>(BFMatcherSettings::normTypeOf(*bf), false);
+    this->crossCheck = true;
+  }
+}
 
-  this->goodTh = gth;
+/**
+ * Extract the features of a single frame
+ */
+void Tracker::extractFrame(const Mat &image, vector<KeyPoint> &keypoints,
+                           Mat &descriptors) {
+  this->detector->detectAndCompute(image, noArray(), keypoints, descriptors);
 }
 
 void Tracker::runExtract() {
-  STACK_TRACE(__PRETTY_FUNCTION__);
+  LOG_FUNCTION(__PRETTY_FUNCTION__);
   for (int i = 0; i < 2; i++) {
-    this->detector->detectAndCompute(this->inputImage[i], noArray(),
-                                     this->keypoints[i], this->descriptors[i]);
+    if (this->extracted[i]) {
+      continue;
+    }
+
+    this->extractFrame(this->inputImage[i], this->keypoints[i],
+                       this->descriptors[i]);
+    this->extracted[i] = true;
   }
 }
 
 void Tracker::_runExtract() {
-  STACK_TRACE(__PRETTY_FUNCTION__);
+  LOG_FUNCTION(__PRETTY_FUNCTION__);
+  TRACE_SPAN(this->name, "extract");
   assert(!detector.empty());
 
   this->runExtract();
 }
 
 void Tracker::runTrack() {
-  STACK_TRACE(__PRETTY_FUNCTION__);
+  LOG_FUNCTION(__PRETTY_FUNCTION__);
+  assert(!matcher.empty());
+
+  LOG_DEBUG("Descriptors Of Image 1");
+  LOG_DEBUG(this->descriptors[0].size());
+  LOG_DEBUG("Descriptors Of Image 2");
+  LOG_DEBUG(this->descriptors[1].size());
+
+  Ptr<L2GemmMatcher> gemm = this->matcher.dynamicCast<L2GemmMatcher>();
+  Ptr<AnnMatcher> ann = this->matcher.dynamicCast<AnnMatcher>();
+  int neighbours = 1;
+
+  for (size_t i = 0; i < this->filters.size(); i++) {
+    neighbours = max(neighbours, this->filters[i]->getNeighbours());
+  }
+
+  // The runner-up comes cheap from the specialized matchers, the others
+  // only search it when a filter compares against it
+  if (gemm) {
+    // Cross-check comes for free from the same distances
+    gemm->knnMatch2Way(this->descriptors[0], this->descriptors[1],
+                       this->knnMatches, this->reverseKnnMatches);
+  } else if (ann) {
+    // The index of a fixed reference frame is built once
+    if (!this->referenceKept || !ann->isTrained()) {
+      ann->setReference(this->descriptors[1]);
+    }
 
-  maxDist = 0;
-  minDist = 100000;
+    ann->knnMatch(this->descriptors[0], this->knnMatches, 2);
+    this->reverseKnnMatches.clear();
+  } else if (neighbours < 2) {
+    this->matcher->match(this->descriptors[0], this->descriptors[1],
+                         this->matches);
+    this->knnMatches.clear();
+    this->reverseKnnMatches.clear();
+    return;
+  } else {
+    this->knnMatcher->knnMatch(this->descriptors[0], this->descriptors[1],
+                               this->knnMatches, neighbours);
+    this->reverseKnnMatches.clear();
+
+    if (this->crossCheck) {
+      this->knnMatcher->knnMatch(this->descriptors[1], this->descriptors[0],
+                                 this->reverseKnnMatches, 1);
+    }
+  }
 
-  TRACE_LINE(__FILE__, __LINE__);
+  this->matches.clear();
+  this->matches.reserve(this->knnMatches.size());
 
-  LOG("Descriptors Of Image 1");
-  DEBUG_STREAM(this->descriptors[0].size());
-  LOG("Descriptors Of Image 2");
-  DEBUG_STREAM(this->descriptors[1].size());
+  for (size_t i = 0; i < this->knnMatches.size(); i++) {
+    if (this->knnMatches[i].empty()) {
+      continue;
+    }
 
-  this->matcher->match(this->descriptors[0], this->descriptors[1],
-                       this->matches);
+    const DMatch &best = this->knnMatches[i][0];
 
-  std::sort(matches.begin(), matches.end(),
-            [](DMatch a, DMatch b) { return a.distance < b.distance; });
+    // Keep the cross-checking matcher's results
+    if (this->crossCheck &&
+        (this->reverseKnnMatches[best.trainIdx].empty() ||
+         this->reverseKnnMatches[best.trainIdx][0].trainIdx != (int)i)) {
+      continue;
+    }
 
-  TRACE_LINE(__FILE__, __LINE__);
+    this->matches.push_back(best);
+  }
 
-  minDist = matches[0].distance;
-  maxDist = matches[matches.size() - 1].distance;
+  LOG_POINT();
 }
 
 void Tracker::_runTrack() {
-  STACK_TRACE(__PRETTY_FUNCTION__);
-  assert(!matcher.empty());
+  LOG_FUNCTION(__PRETTY_FUNCTION__);
+  TRACE_SPAN(this->name, "match");
 
   this->runTrack();
 }
 
 void Tracker::runFilter() {
-  STACK_TRACE(__PRETTY_FUNCTION__);
-
-  double normDistance;
-  vector<DMatch> goodMatches;
+  LOG_FUNCTION(__PRETTY_FUNCTION__);
+  assert(!matcher.empty());
+  MatchContext context;
 
-  for (int i = 0; i < this->descriptors[0].rows; i++) {
-    normDistance = (matches[i].distance - minDist) / (maxDist - minDist);
+  for (int i = 0; i < 2; i++) {
+    context.keypoints[i] = &this->keypoints[i];
+    context.descriptors[i] = &this->descriptors[i];
+    context.imageSize[i] = this->inputImage[i].size();
+  }
 
-    // Since it's pre-ordered
-    if (normDistance > this->goodTh) {
-      break;
-    }
+  context.knnMatches = &this->knnMatches;
+  context.reverseKnnMatches =
+      this->reverseKnnMatches.empty() ? NULL : &this->reverseKnnMatches;
+  context.matcher = this->matcher;
 
-    goodMatches.push_back(matches[i]);
+  if (this->filters.empty()) {
+    this->distanceFilter->setThreshold(this->goodTh);
+    this->distanceFilter->filter(context, this->matches);
+    return;
   }
 
-  matches.clear();
-
-  matches = goodMatches;
+  for (size_t i = 0; i < this->filters.size(); i++) {
+    this->filters[i]->filter(context, this->matches);
+  }
 }
 
 void Tracker::matchesToKeypoints(vector<KeyPoint> &kp1, vector<KeyPoint> &kp2) {
-  STACK_TRACE(__PRETTY_FUNCTION__);
+  LOG_FUNCTION(__PRETTY_FUNCTION__);
   kp1.clear();
   kp2.clear();
 
@@ -136,7 +270,7 @@ void Tracker::matchesToKeypoints(vector<KeyPoint> &kp1, vector<KeyPoint> &kp2) {
 }
 
 void Tracker::matchesToPoints(vector<Point2f> &p1, vector<Point2f> &p2) {
-  STACK_TRACE(__PRETTY_FUNCTION__);
+  LOG_FUNCTION(__PRETTY_FUNCTION__);
   vector<KeyPoint> kp1;
   vector<KeyPoint> kp2;
   // p1.clear();
@@ -144,34 +278,39 @@ void Tracker::matchesToPoints(vector<Point2f> &p1, vector<Point2f> &p2) {
 
   matchesToKeypoints(kp1, kp2);
 
-  LOG("Keypoints Of Image 1");
-  DEBUG_STREAM(kp1.size());
-  LOG("Keypoints Of Image 2");
-  DEBUG_STREAM(kp2.size());
+  LOG_DEBUG("Keypoints Of Image 1");
+  LOG_DEBUG(kp1.size());
+  LOG_DEBUG("Keypoints Of Image 2");
+  LOG_DEBUG(kp2.size());
 
   KeyPoint::convert(kp1, p1);
   KeyPoint::convert(kp2, p2);
 
-  LOG("Points Of Image 1");
-  DEBUG_STREAM(p1.size());
-  LOG("Points Of Image 2");
-  DEBUG_STREAM(p2.size());
+  LOG_DEBUG("Points Of Image 1");
+  LOG_DEBUG(p1.size());
+  LOG_DEBUG("Points Of Image 2");
+  LOG_DEBUG(p2.size());
 
-  TRACE_LINE(__FILE__, __LINE__);
+  LOG_POINT();
 }
 
 void Tracker::_runFilter() {
-  STACK_TRACE(__PRETTY_FUNCTION__);
-  assert(!matcher.empty());
+  LOG_FUNCTION(__PRETTY_FUNCTION__);
+  TRACE_SPAN(this->name, "filter");
 
   this->runFilter();
 }
 
 void Tracker::track(Mat img1, Mat img2) {
-  STACK_TRACE(__PRETTY_FUNCTION__);
+  LOG_FUNCTION(__PRETTY_FUNCTION__);
 
-  this->inputImage[0] = img1;
-  this->inputImage[1] = img2;
+  this->track(img1, -1, img2, -1);
+}
+
+void Tracker::track(Mat img1, int64 id1, Mat img2, int64 id2) {
+  LOG_FUNCTION(__PRETTY_FUNCTION__);
+
+  this->loadInputs(img1, id1, img2, id2);
 
   this->_runExtract();
   this->_runTrack();
@@ -179,58 +318,278 @@ void Tracker::track(Mat img1, Mat img2) {
 }
 
 void Tracker::track(Mat img1, Mat img2, int k) {
-  STACK_TRACE(__PRETTY_FUNCTION__);
-  vector<DMatch> tmp;
+  LOG_FUNCTION(__PRETTY_FUNCTION__);
 
-  this->inputImage[0] = img1;
-  this->inputImage[1] = img2;
+  this->loadInputs(img1, -1, img2, -1);
 
   this->_runExtract();
   this->_runTrack();
   this->_runFilter();
 
-  tmp = matches;
-  matches.clear();
+  if (k > this->matches.size()) {
+    k = this->matches.size();
+  }
+
+  // Only the k best need ordering
+  partial_sort(this->matches.begin(), this->matches.begin() + k,
+               this->matches.end(), [](const DMatch &a, const DMatch &b) {
+                 return a.distance < b.distance;
+               });
+  this->matches.resize(k);
+}
+
+/**
+ * Track every consecutive pair of a sequence of frames
+ */
+void Tracker::trackSequence(FrameSource source, PairSink sink, size_t depth) {
+  LOG_FUNCTION(__PRETTY_FUNCTION__);
+  BoundedQueue<SequenceFrame> readQueue(depth), extractQueue(depth);
+  StageStats &matchStats = this->stageStats[2];
+  exception_ptr readFailure, extractFailure;
+  SequenceFrame frame;
+  Timing timing;
+  Mat prev;
+  int idx = 0;
+
+  // Sequence frames are numbered from 0, earlier pairs ids don't apply
+  this->frameId[0] = this->frameId[1] = -1;
+
+  if (depth == 0) {
+    // Stages run back to back, never blocked nor queued
+    auto record = [](StageStats &stats, double busy) {
+      stats.busy.push_back(busy);
+      stats.wait.push_back(0);
+      stats.queued.push_back(0);
+    };
+
+    for (int64 id = 0;; id++) {
+      Mat curr;
+
+      timing.start();
+      bool more = source(curr);
+      timing.end();
+
+      if (!more) {
+        break;
+      }
+
+      record(this->stageStats[0], timing.getDelta());
+
+      if (id > 0) {
+        this->loadInputs(prev, id - 1, curr, id);
+
+        timing.start();
+        this->_runExtract();
+        timing.end();
+        record(this->stageStats[1], timing.getDelta());
+
+        timing.start();
+        this->_runTrack();
+        this->_runFilter();
+        timing.end();
+        record(matchStats, timing.getDelta());
+
+        sink(idx++);
+      }
+
+      prev = curr;
+    }
+
+    this->frameId[0] = this->frameId[1] = -1;
+    return;
+  }
+
+  thread reader([this, &source, &readQueue, &readFailure] {
+    StageStats &stats = this->stageStats[0];
+    Timing timing;
+
+    try {
+      while (true) {
+        SequenceFrame frame;
+
+        timing.start();
+        bool more = source(frame.image);
+        timing.end();
+
+        if (!more) {
+          break;
+        }
+
+        stats.busy.push_back(timing.getDelta());
+
+        timing.start();
+        bool pushed = readQueue.push(frame);
+        timing.end();
+        stats.wait.push_back(timing.getDelta());
+
+        if (!pushed) {
+          break;
+        }
+      }
+    } catch (...) {
+      readFailure = current_exception();
+    }
+
+    readQueue.close();
+  });
+
+  thread extractor([this, &readQueue, &extractQueue, &extractFailure] {
+    StageStats &stats = this->stageStats[1];
+    SequenceFrame frame;
+    Timing timing;
+    double wait = 0;
+
+    try {
+      while (true) {
+        stats.queued.push_back((int)readQueue.size());
+
+        timing.start();
+        bool more = readQueue.pop(frame);
+        timing.end();
+        wait = timing.getDelta();
+
+        if (!more) {
+          break;
+        }
+
+        timing.start();
+        {
+          TRACE_SPAN(this->name, "extract");
+          this->extractFrame(frame.image, frame.keypoints, frame.descriptors);
+        }
+        timing.end();
+        stats.busy.push_back(timing.getDelta());
+
+        timing.start();
+        bool pushed = extractQueue.push(frame);
+        timing.end();
+        stats.wait.push_back(wait + timing.getDelta());
+
+        if (!pushed) {
+          break;
+        }
+      }
+    } catch (...) {
+      extractFailure = current_exception();
+    }
+
+    // Unblock the reader if the matcher gave up early or extraction failed
+    extractQueue.close();
+    readQueue.close();
+  });
+
+  try {
+    for (bool first = true;; first = false) {
+      matchStats.queued.push_back((int)extractQueue.size());
+
+      timing.start();
+      bool more = extractQueue.pop(frame);
+      timing.end();
+
+      if (!more) {
+        break;
+      }
+
+      matchStats.wait.push_back(timing.getDelta());
+
+      // The previous second image is the new first one
+      swap(this->keypoints[0], this->keypoints[1]);
+      this->descriptors[0] = this->descriptors[1];
+      this->inputImage[0] = this->inputImage[1];
+      this->keypoints[1].swap(frame.keypoints);
+      this->descriptors[1] = frame.descriptors;
+      this->inputImage[1] = frame.image;
+
+      if (first) {
+        continue;
+      }
+
+      this->extracted[0] = this->extracted[1] = true;
+      this->referenceKept = false;
+
+      timing.start();
+      this->_runTrack();
+      this->_runFilter();
+      timing.end();
+      matchStats.busy.push_back(timing.getDelta());
+
+      sink(idx++);
+    }
+  } catch (...) {
+    readQueue.close();
+    extractQueue.close();
+    reader.join();
+    extractor.join();
+    throw;
+  }
+
+  reader.join();
+  extractor.join();
+
+  // The pairs before the failing frame were already delivered
+  if (readFailure) {
+    rethrow_exception(readFailure);
+  }
 
-  if (k > tmp.size()) {
-    k = tmp.size();
+  if (extractFailure) {
+    rethrow_exception(extractFailure);
   }
+}
 
-  for (int i = 0; i < k; i++) {
-    matches.push_back(tmp[i]);
+/**
+ * Set the input images, reusing the previous second image features
+ */
+void Tracker::loadInputs(Mat img1, int64 id1, Mat img2, int64 id2) {
+  bool known = this->sequential && this->extracted[1] && this->frameId[1] >= 0;
+  bool keep = known && id2 == this->frameId[1];
+  bool reuse = !keep && known && id1 == this->frameId[1];
+
+  if (reuse) {
+    swap(this->keypoints[0], this->keypoints[1]);
+    swap(this->descriptors[0], this->descriptors[1]);
   }
+
+  this->reuseStats.push_back(reuse || keep ? 1 : 0);
+
+  this->inputImage[0] = img1;
+  this->inputImage[1] = img2;
+  this->frameId[0] = id1;
+  this->frameId[1] = id2;
+  this->extracted[0] = reuse;
+  this->extracted[1] = keep;
+  this->referenceKept = keep;
 }
 
 void Tracker::updateOutputImage() {
-  STACK_TRACE(__PRETTY_FUNCTION__);
+  LOG_FUNCTION(__PRETTY_FUNCTION__);
 
   assert(this->inputImage[0].rows != 0 && this->inputImage[0].cols != 0);
   assert(this->inputImage[1].rows != 0 && this->inputImage[1].cols != 0);
   assert(this->keypoints[0].size() != 0);
   assert(this->keypoints[1].size() != 0);
   assert(matches.size() != 0);
-  TRACE_LINE(__FILE__, __LINE__);
+  LOG_POINT();
   drawMatches(this->inputImage[0], this->keypoints[0], this->inputImage[1],
               this->keypoints[1], matches, this->outputImage[2],
               Scalar::all(-1), Scalar::all(-1), vector<char>(),
               DrawMatchesFlags::NOT_DRAW_SINGLE_POINTS |
                   DrawMatchesFlags::DRAW_RICH_KEYPOINTS);
 
-  TRACE_LINE(__FILE__, __LINE__);
+  LOG_POINT();
 
   drawKeypoints(this->inputImage[0], this->keypoints[0], this->outputImage[0],
                 Scalar::all(-1), DrawMatchesFlags::DRAW_RICH_KEYPOINTS);
-  TRACE_LINE(__FILE__, __LINE__);
+  LOG_POINT();
   drawKeypoints(this->inputImage[1], this->keypoints[1], this->outputImage[1],
                 Scalar::all(-1), DrawMatchesFlags::DRAW_RICH_KEYPOINTS);
-  TRACE_LINE(__FILE__, __LINE__);
+  LOG_POINT();
 }
 
 /**
  * Show the GUI
  */
 void Tracker::show() {
-  STACK_TRACE(__PRETTY_FUNCTION__);
+  LOG_FUNCTION(__PRETTY_FUNCTION__);
 
   if (!this->showEnable) {
     return;
@@ -241,14 +600,51 @@ void Tracker::show() {
   namedWindow(this->name + " - Image - 1", WINDOW_GUI_EXPANDED);
   namedWindow(this->name + " - Image - 2", WINDOW_GUI_EXPANDED);
   namedWindow(this->name, WINDOW_GUI_EXPANDED);
-  LOG("Showing image - 1");
+  LOG_DEBUG("Showing image - 1");
   imshow(this->name + " - Image - 1", this->outputImage[0]);
-  LOG("Showing image - 2");
+  LOG_DEBUG("Showing image - 2");
   imshow(this->name + " - Image - 2", this->outputImage[1]);
-  LOG("Showing Matches");
+  LOG_DEBUG("Showing Matches");
   imshow(this->name, this->outputImage[2]);
 }
 
 void Tracker::setMatchingThreshold(double threshold) {
   this->goodTh = threshold;
 }
+
+/**
+ * Enable reusing the features of sequential pairs
+ */
+void Tracker::setSequential(bool enable) { this->sequential = enable; }
+
+/**
+ * Print the tracker statistics
+ */
+void Tracker::printStats() {
+  Ptr<AnnMatcher> ann = this->matcher.dynamicCast<AnnMatcher>();
+
+  cout << this->reuseStats.str();
+
+  if (ann) {
+    ann->printStats();
+  }
+
+  if (this->filters.empty()) {
+    this->distanceFilter->printStats();
+  }
+
+  for (size_t i = 0; i < this->filters.size(); i++) {
+    this->filters[i]->printStats();
+  }
+
+  for (size_t i = 0; i < this->stageStats.size(); i++) {
+    this->stageStats[i].print();
+  }
+}
+
+/**
+ * Append a filter to the matches filtering pipeline
+ */
+void Tracker::addFilter(Ptr<MatchFilter> filter) {
+  this->filters.push_back(filter);
+}
@@ -24,16 +24,27 @@
  */
 #include <dirent.h>
 #include <iostream>
+#include <sstream>
 #include <sys/stat.h>
 
 // External
 #include <opencv2/opencv.hpp>
 
 // Internal
+#include <trackers/GuidedMatcher.hpp>
+#include <trackers/Int8Matcher.hpp>
+#include <trackers/L2GemmMatcher.hpp>
+#include <trackers/ParallelFeaturesFinder.hpp>
+#include <trackers/TrackStore.hpp>
 #include <trackers/Tracker.hpp>
-#include <util/Debug.hpp>
+#include <util/Log.hpp>
 #include <util/Mosaic.hpp>
+#include <util/ReducedDecode.hpp>
 #include <util/CustomSerializer.hpp>
+#include <util/DescriptorQuantizer.hpp>
+#include <util/FrameCache.hpp>
+#include <util/Timing.hpp>
+#include <util/Trace.hpp>
 
 using namespace cv;
 using namespace cv::xfeatures2d;
@@ -50,7 +61,17 @@ static String keys = "{help h usage ? |      | Print this message    }"
                      "{show           |      | Display images        }"
                      "{finder         |      | Feature Finder        }"
                      "{extract        |      | Extract Features      }"
-                     "{match          |      | Match Features        }";
+                     "{threads        | 1    | Extraction Threads    }"
+                     "{match          |      | Match Features        }"
+                     "{matcher        |      | Features Matcher      }"
+                     "{guided         |      | Guided Matching       }"
+                     "{guided_radius  | 40   | Guided Search Radius  }"
+                     "{quantize       |      | Int8 Descriptors      }"
+                     "{match_window   | 0    | Matched Neighbours    }"
+                     "{match_pairs    |      | Extra Matched Pairs   }"
+                     "{cache_mem      | 0    | Frame Cache MB        }"
+                     "{cache_dir      |      | Frame Cache Directory }"
+                     "{trace          |      | Trace Output Path     }";
 
 const string featuresFile("features.yml");
 
@@ -63,6 +84,7 @@ static const int imageWidth = 3648;
 static const double focalLength = 4419.441;
 static const double principalPointX = 2708.765;
 static const double principalPointY = 1775.895;
+static const Size fullSize(imageWidth, imageHeight);
 static const Size scaled(imageWidth * scaleFactor, imageHeight * scaleFactor);
 static const char * image1Window = "Image 1";
 static const char * image2Window = "Image 2";
@@ -73,14 +95,20 @@ static vector<string> inputImagesPaths;
 static vector<Mat> inputImages;
 static bool enableGui;
 static int key = 0;
-static Ptr<FeaturesFinder> finder;
+static ParallelFeaturesFinder::FinderFactory finderFactory;
+static Ptr<FeaturesMatcher> featuresMatcher;
+static Ptr<GuidedMatcher> guidedMatcher;
+static Ptr<FrameCache> frameCache;
 static vector<ImageFeatures> features;
+static bool quantize;
+static float descriptorScale = 0;
 static vector<MatchesInfo> pairwiseMatches;
 static FileStorage fs;
 static vector<CameraParams>	estimatedCamerasParams;
 static CameraParams specifiedCameraParams;
 static vector<Mat> homography;
 static vector<MatchesInfo> seqMatchesInfo;
+static TrackStore trackStore;
 static vector<vector<Mat>> calculatedRotation;
 static vector<vector<Mat>> calculatedTranslation;
 static Ptr<WarperCreator> warperCreator = makePtr<cv::CompressedRectilinearWarper>();
@@ -119,7 +147,7 @@ void parserInputImagesFiles() {
   DIR *dir;
 
   if (!parser->has("indir")) {
-    DEBUG_STREAM( "No input file specified" );
+    LOG_ERROR("No input file specified");
     exit(-1);
   }
 
@@ -129,7 +157,7 @@ void parserInputImagesFiles() {
   if ((dir = opendir(indir.c_str())) != NULL) {
     /* print all the files and directories within directory */
     while ((ent = readdir(dir)) != NULL) {
-      // DEBUG_STREAM( "file: " << ent->d_name );
+      // LOG_DEBUG( "file: " << ent->d_name );
       if (ent->d_type != DT_REG) {
         continue;
       }
@@ -155,15 +183,15 @@ void parserInputImagesFiles() {
 }
 
 void versionPrinting() {
-  DEBUG_STREAM( "OpenCV Version: " << CV_MAJOR_VERSION << "." << CV_MINOR_VERSION);
+  LOG_DEBUG( "OpenCV Version: " << CV_MAJOR_VERSION << "." << CV_MINOR_VERSION);
 
-  DEBUG_STREAM("C++ Standard: ");
+  LOG_DEBUG("C++ Standard: ");
   if (__cplusplus == 201103L) {
-    DEBUG_STREAM( "C++11" );
+    LOG_DEBUG( "C++11" );
   } else if (__cplusplus == 19971L) {
-    DEBUG_STREAM( "C++98" );
+    LOG_DEBUG( "C++98" );
   } else {
-    DEBUG_STREAM( "pre-standard C++" );
+    LOG_DEBUG( "pre-standard C++" );
   }
 }
 
@@ -188,77 +216,95 @@ bool waitAndContinue() {
 }
 
 void readImage(Mat &image, int i) {
+  TRACE_SPAN("readImage", "decode");
   assert(i < inputImagesPaths.size());
 
-  image = imread(indir + "/" + inputImagesPaths[i]);
+  string path = indir + "/" + inputImagesPaths[i];
+
+  // Every stage reads the same scaled frames
+  image = frameCache->get(path, scaled, IMREAD_COLOR, [&path] {
+    return ReducedDecode::read(path, scaled, fullSize);
+  });
   assert(!image.empty());
-  resize(image, image, scaled);
 }
 
 void readImages(Mat images[2], int i) {
+  TRACE_SPAN("readImages", "decode");
   assert(i < inputImagesPaths.size() - 1);
 
   if (images[PREV_IDX].empty()){
-    images[PREV_IDX] = imread(indir + "/" + inputImagesPaths[i]);
-    assert(!images[PREV_IDX].empty());
-    resize(images[PREV_IDX], images[PREV_IDX], scaled);
+    readImage(images[PREV_IDX], i);
   } else {
-    images[CURR_IDX].copyTo(images[PREV_IDX]);
+    // The next read allocates a new buffer, no copy needed
+    images[PREV_IDX] = images[CURR_IDX];
   }
 
-  images[CURR_IDX] = imread(indir + "/" + inputImagesPaths[i + 1]);
-  assert(!images[CURR_IDX].empty());
-  resize(images[CURR_IDX], images[CURR_IDX], scaled);
+  readImage(images[CURR_IDX], i + 1);
 }
 
 void printFeaturesStats(int i) {
-  DEBUG_STREAM(inputImagesPaths[i] << " # features " << features[i].keypoints.size());
+  LOG_DEBUG(inputImagesPaths[i] << " # features " << features[i].keypoints.size());
 }
 
 void printMatchesStats(int i, MatchesInfo info) {
   assert(i < inputImagesPaths.size() - 1);
 
-  DEBUG_STREAM(inputImagesPaths[i] << " -> " << inputImagesPaths[i + 1] << " # Matches " << info.matches.size());
+  LOG_DEBUG(inputImagesPaths[i] << " -> " << inputImagesPaths[i + 1] << " # Matches " << info.matches.size());
 }
 
-void findFeatures(Mat images[2], int i) {
-  assert(i < inputImagesPaths.size() - 1);
+void parserFinder() {
+  string finderName("");
 
-  // For the first run
-  if (features[i].keypoints.empty()){
-    (*finder)(images[PREV_IDX],	features[i]);
-    features[i].img_idx = i;
-    printFeaturesStats(i);
+  if (parser->has("finder")) {
+    finderName = parser->get<string>("finder");
   }
 
-  (*finder)(images[CURR_IDX],	features[i + 1]);
-  features[i + 1].img_idx = i + 1;
-  printFeaturesStats(i + 1);
+  // Every extraction thread gets its own finder
+  if (finderName == "orb") {
+    finderFactory = [] { return Ptr<FeaturesFinder>(makePtr<OrbFeaturesFinder>()); };
+    return;
+  }
+
+  if (finderName.empty()) {
+    LOG_DEBUG("Unspecified finder using SURF");
+  } else if (finderName != "surf") {
+    LOG_DEBUG("Unsupported finder using SURF");
+  }
+
+  finderFactory = [] { return Ptr<FeaturesFinder>(makePtr<SurfFeaturesFinder>()); };
 }
 
-void parserFinder() {
-  string finderName("");
+void parserMatcher() {
+  string matcherName("");
 
-  if (!parser->has("finder")) {
-    LOG("Unspecified finder using SURF");
-    finder = makePtr<SurfFeaturesFinder>();
-    return;
+  if (parser->has("guided")) {
+    guidedMatcher = makePtr<GuidedMatcher>(parser->get<float>("guided_radius"), match_conf);
   }
 
-  finderName = parser->get<string>("finder");
+  if (parser->has("matcher")) {
+    matcherName = parser->get<string>("matcher");
+  }
+
+  if (quantize) {
+    if (!matcherName.empty()) {
+      LOG_WARN("Ignoring matcher " << matcherName << " with quantized descriptors");
+    }
 
-  if (finderName == "surf") {
-    finder = makePtr<SurfFeaturesFinder>();
+    featuresMatcher = makePtr<Int8FeaturesMatcher>(match_conf);
     return;
   }
 
-  if (finderName == "orb") {
-    finder = makePtr<OrbFeaturesFinder>();
+  // The GEMM matcher only handles float descriptors
+  if (matcherName == "gemm" && parser->get<string>("finder") != "orb") {
+    featuresMatcher = makePtr<GemmFeaturesMatcher>(match_conf);
     return;
   }
 
-  LOG("Unsupported finder using SURF");
-  finder = makePtr<SurfFeaturesFinder>();
+  if (matcherName != "" && matcherName != "best2") {
+    LOG_WARN("Unsupported matcher " << matcherName << " using BestOf2Nearest");
+  }
+
+  featuresMatcher = makePtr<BestOf2NearestMatcher>(false, match_conf);
 }
 
 inline bool checkFileExists(const std::string& name) {
@@ -266,8 +312,40 @@ inline bool checkFileExists(const std::string& name) {
   return (stat (name.c_str(), &buffer) == 0);
 }
 
+void quantizeFeatures() {
+  TRACE_SPAN("quantizeFeatures", "stage");
+  vector<Mat> descriptors(features.size());
+
+  for (int i = 0; i < features.size(); i++) {
+    descriptors[i] = features[i].descriptors.getMat(ACCESS_READ);
+  }
+
+  // One scale for all the images, so their distances are comparable
+  descriptorScale = DescriptorQuantizer::fitScale(descriptors);
+
+  for (int i = 0; i < features.size(); i++) {
+    Mat quantized;
+
+    DescriptorQuantizer::quantize(descriptors[i], descriptorScale, quantized);
+    descriptors[i].release();
+    quantized.copyTo(features[i].descriptors);
+  }
+
+  LOG_DEBUG("Quantized descriptors with scale " << descriptorScale);
+}
+
+void dequantizeFeatures() {
+  for (int i = 0; i < features.size(); i++) {
+    Mat desc;
+
+    DescriptorQuantizer::dequantize(features[i].descriptors.getMat(ACCESS_READ),
+                                    descriptorScale, desc);
+    desc.copyTo(features[i].descriptors);
+  }
+}
+
 void parseFeatures() {
-  Mat images[2];
+  TRACE_SPAN("parseFeatures", "stage");
   vector<ImageFeaturesSerializer> serFeatures(features.size());
   FileStorage fs;
 
@@ -277,39 +355,55 @@ void parseFeatures() {
 
   if (parser->has("extract") || !checkFileExists(featuresFile)) {
 
-    // Extract all features
-    for (int i = 0; i < inputImagesPaths.size() - 1; i++) {
-      readImages(images, i);
-      TRACE_LINE(__FILE__, __LINE__);
+    ParallelFeaturesFinder extract(finderFactory, parser->get<int>("threads"));
+    Timing timing;
+
+    // Extract all features, every image on its own
+    timing.start();
+    extract([](int i, Mat &image) { readImage(image, i); }, features);
+    timing.end();
 
-      // Get the features
-      findFeatures(images, i);
+    for (int i = 0; i < features.size(); i++) {
+      printFeaturesStats(i);
+    }
+
+    LOG_DEBUG("Extracted " << features.size() << " images in " << timing.getDelta() << "s with " << extract.getThreads() << " threads");
+
+    if (parser->has("v")) {
+      extract.printStats();
+    }
+
+    if (quantize) {
+      quantizeFeatures();
     }
 
     fs = FileStorage(featuresFile, FileStorage::WRITE);
     fs << "features" << serFeatures;
+    if (quantize) {
+      fs << "descriptor_scale" << descriptorScale;
+    }
     fs.release();
     return;
   }
 
   fs = FileStorage(featuresFile, FileStorage::READ);
   fs["features"] >> serFeatures;
+  if (!fs["descriptor_scale"].empty()) {
+    fs["descriptor_scale"] >> descriptorScale;
+  }
   fs.release();
-}
-
-MatchesInfo findMatchInfo(vector<MatchesInfo> matches, int src, int dst) {
-  auto it = find_if(matches.begin(),
-                  matches.end(),
-                  [&src, &dst](const MatchesInfo& obj) {
-                    return (obj.src_img_idx == src) && (obj.dst_img_idx == dst);
-                  });
-
-  assert(it != matches.end());
 
-  return matches[distance(matches.begin(), it)];
+  // Stored descriptors may not match the requested precision
+  if (quantize && descriptorScale == 0) {
+    quantizeFeatures();
+  } else if (!quantize && descriptorScale != 0) {
+    dequantizeFeatures();
+    descriptorScale = 0;
+  }
 }
 
 void warpImages(Mat images[2], int i) {
+  TRACE_SPAN("warpImages", "warp");
   Mat warpedImage;
   Mat fullImage;
 
@@ -326,11 +420,13 @@ void warpImages(Mat images[2], int i) {
   }
 
   if (outEnable) {
+    TRACE_SPAN("imwrite", "write");
     imwrite(outdir + "/" + getFileRoot(inputImagesPaths[i]) + "/warped_" + inputImagesPaths[i], fullImage);
   }
 }
 
 void createImages() {
+  TRACE_SPAN("createImages", "stage");
   Mat images[2];
   Mat imagesWithFeatures[2];
   Mat matchesImage;
@@ -348,7 +444,7 @@ void createImages() {
   // Extract all features
   for (int i = 0; i < inputImagesPaths.size() - 1; i++) {
     readImages(images, i);
-    TRACE_LINE(__FILE__, __LINE__);
+    LOG_POINT();
 
     if (outEnable) {
       currOutDir = outdir + "/" + getFileRoot(inputImagesPaths[i]) + "/";
@@ -368,6 +464,7 @@ void createImages() {
 
 
     if (outEnable) {
+      TRACE_SPAN("imwrite", "write");
       imwrite(currOutDir + inputImagesPaths[i], images[PREV_IDX]);
       imwrite(currOutDir + inputImagesPaths[i + 1], images[CURR_IDX]);
       imwrite(currOutDir + "features_" + inputImagesPaths[i], imagesWithFeatures[PREV_IDX]);
@@ -391,14 +488,18 @@ void createImages() {
 
     printMatchesStats(i, currMatch);
 
-    drawMatches(images[PREV_IDX],
-                features[i].keypoints,
-                images[CURR_IDX],
-                features[i + 1].keypoints,
-                currMatch.matches,
-                matchesImage);
+    {
+      TRACE_SPAN("drawMatches", "render");
+      drawMatches(images[PREV_IDX],
+                  features[i].keypoints,
+                  images[CURR_IDX],
+                  features[i + 1].keypoints,
+                  currMatch.matches,
+                  matchesImage);
+    }
 
     if (outEnable) {
+      TRACE_SPAN("imwrite", "write");
       imwrite(currOutDir + "matches_" + inputImagesPaths[i], matchesImage);
     }
 
@@ -412,7 +513,7 @@ void createImages() {
 
     }
 
-    LOG("Warping");
+    LOG_DEBUG("Warping");
     warpImages(images, i);
 
     if (!waitAndContinue()) {
@@ -431,18 +532,19 @@ void createImages() {
 }
 
 void estimateCameraParams() {
+  TRACE_SPAN("estimateCameraParams", "stage");
   HomographyBasedEstimator estimator;
 
   if	(!estimator(features,	pairwiseMatches,	estimatedCamerasParams)) {
-      DEBUG_STREAM("Homography	estimation	failed.");
+      LOG_DEBUG("Homography	estimation	failed.");
       return;
   }
 
   for (int i = 0; i < inputImagesPaths.size(); i++) {
-    DEBUG_STREAM( "Camera Params Image - " << inputImagesPaths[i]);
-    DEBUG_STREAM( "  K = " << estimatedCamerasParams[i].K());
-    DEBUG_STREAM( "  R = " << estimatedCamerasParams[i].R);
-    DEBUG_STREAM( "  t = " << estimatedCamerasParams[i].t);
+    LOG_DEBUG( "Camera Params Image - " << inputImagesPaths[i]);
+    LOG_DEBUG( "  K = " << estimatedCamerasParams[i].K());
+    LOG_DEBUG( "  R = " << estimatedCamerasParams[i].R);
+    LOG_DEBUG( "  t = " << estimatedCamerasParams[i].t);
 
     estimatedCamerasParams[i].R.convertTo(estimatedCamerasParams[i].R, CV_32F);
   }
@@ -455,21 +557,22 @@ void adjustCameraParams() {
   adjuster->setConfThresh(confThresh);
 
   if	(!(*adjuster)(features,	pairwiseMatches,	estimatedCamerasParams)) {
-      LOG("Adjusting camera parameters	failed.");
+      LOG_DEBUG("Adjusting camera parameters	failed.");
       return;
   }
 
   for (int i = 0; i < inputImagesPaths.size(); i++) {
-    DEBUG_STREAM( "Camera Params Image - " << inputImagesPaths[i]);
-    DEBUG_STREAM( "  K = " << estimatedCamerasParams[i].K());
-    DEBUG_STREAM( "  R = " << estimatedCamerasParams[i].R);
-    DEBUG_STREAM( "  t = " << estimatedCamerasParams[i].t);
+    LOG_DEBUG( "Camera Params Image - " << inputImagesPaths[i]);
+    LOG_DEBUG( "  K = " << estimatedCamerasParams[i].K());
+    LOG_DEBUG( "  R = " << estimatedCamerasParams[i].R);
+    LOG_DEBUG( "  t = " << estimatedCamerasParams[i].t);
 
     estimatedCamerasParams[i].R.convertTo(estimatedCamerasParams[i].R, CV_32F);
   }
 }
 
 void calcHomographyMatrix() {
+  TRACE_SPAN("calcHomographyMatrix", "stage");
   MatchesInfo currInfo;
   vector<Point2f> srcPoints, dstPoints;
   Mat H;
@@ -479,8 +582,8 @@ void calcHomographyMatrix() {
     currInfo = seqMatchesInfo[i];
 
     if (currInfo.confidence == 0) {
-      DEBUG_STREAM("Homography of " << inputImagesPaths[i + 1] << " -> " << inputImagesPaths[i] << " - NOT FOUND");
-//      DEBUG_STREAM(" H = NULL");
+      LOG_DEBUG("Homography of " << inputImagesPaths[i + 1] << " -> " << inputImagesPaths[i] << " - NOT FOUND");
+//      LOG_DEBUG(" H = NULL");
       continue;
     }
 
@@ -501,10 +604,13 @@ void calcHomographyMatrix() {
       dstPoints.push_back(dst);
     }
 
-    H = findHomography(srcPoints, dstPoints, currInfo.inliers_mask, RANSAC);
+    {
+      TRACE_SPAN("findHomography", "homography");
+      H = findHomography(srcPoints, dstPoints, currInfo.inliers_mask, RANSAC);
+    }
 
-    DEBUG_STREAM("Homography of " << inputImagesPaths[i + 1] << " -> " << inputImagesPaths[i] << " - FOUND");
-//    DEBUG_STREAM(" H = " << H);
+    LOG_DEBUG("Homography of " << inputImagesPaths[i + 1] << " -> " << inputImagesPaths[i] << " - FOUND");
+//    LOG_DEBUG(" H = " << H);
 
     H.copyTo(homography[i]);
 
@@ -528,7 +634,7 @@ void compareProjectedPoints() {
     currInfo = seqMatchesInfo[i];
 
     if (currInfo.confidence == 0) {
-      DEBUG_STREAM("Skipping Comparison of projections of " << inputImagesPaths[i + 1] << " -> " << inputImagesPaths[i]);
+      LOG_DEBUG("Skipping Comparison of projections of " << inputImagesPaths[i + 1] << " -> " << inputImagesPaths[i]);
       continue;
     }
 
@@ -541,59 +647,66 @@ void compareProjectedPoints() {
     perspectiveTransform(inPoints, outPoints, homography[i]);
 
     for (int p = 0; p < currInfo.matches.size(); p++) {
-      DEBUG_STREAM("Original Image Point : " << features[currInfo.dst_img_idx].keypoints[currInfo.matches[p].trainIdx].pt);
-      DEBUG_STREAM("Projected Image Point (before): " << inPoints[p]);
-      DEBUG_STREAM("Projected Image Point : " << outPoints[p]);
+      LOG_DEBUG("Original Image Point : " << features[currInfo.dst_img_idx].keypoints[currInfo.matches[p].trainIdx].pt);
+      LOG_DEBUG("Projected Image Point (before): " << inPoints[p]);
+      LOG_DEBUG("Projected Image Point : " << outPoints[p]);
     }
 
   }
 }
 
 void decomoposeHMatrix() {
+  TRACE_SPAN("decomoposeHMatrix", "stage");
   FileStorage fs;
   Mat K;
 
   specifiedCameraParams.K().copyTo(K);
 
-  DEBUG_STREAM("Specified Camera Matrix ");
-  DEBUG_STREAM(" K = " << K);
+  LOG_DEBUG("Specified Camera Matrix ");
+  LOG_DEBUG(" K = " << K);
 
   for (int i = 0; i < inputImagesPaths.size() - 1; i++) {
     if (seqMatchesInfo[i].confidence == 0) {
-      DEBUG_STREAM("Skipping H decompose of " << inputImagesPaths[i + 1] << " -> " << inputImagesPaths[i]);
+      LOG_DEBUG("Skipping H decompose of " << inputImagesPaths[i + 1] << " -> " << inputImagesPaths[i]);
       continue;
     }
 
-    decomposeHomographyMat(homography[i],
-                           K,
-                           calculatedRotation[i],
-                           calculatedTranslation[i],
-                           noArray());
+    {
+      TRACE_SPAN("decomposeHomographyMat", "decomposition");
+      decomposeHomographyMat(homography[i],
+                             K,
+                             calculatedRotation[i],
+                             calculatedTranslation[i],
+                             noArray());
+    }
 
-    DEBUG_STREAM("Rotation of " << inputImagesPaths[i + 1] << " -> " << inputImagesPaths[i]);
+    LOG_DEBUG("Rotation of " << inputImagesPaths[i + 1] << " -> " << inputImagesPaths[i]);
     for (int o = 0; o < calculatedRotation[i].size(); o++) {
-      DEBUG_STREAM(" R[" << o << "] = " << calculatedRotation[i][o]);
+      LOG_DEBUG(" R[" << o << "] = " << calculatedRotation[i][o]);
     }
 
-    DEBUG_STREAM("Translation of " << inputImagesPaths[i + 1] << " -> " << inputImagesPaths[i]);
+    LOG_DEBUG("Translation of " << inputImagesPaths[i + 1] << " -> " << inputImagesPaths[i]);
     for (int o = 0; o < calculatedTranslation[i].size(); o++) {
-      DEBUG_STREAM(" t[" << o << "]= " << calculatedTranslation[i][o]);
+      LOG_DEBUG(" t[" << o << "]= " << calculatedTranslation[i][o]);
     }
 
-    decomposeHomographyMat(homography[i],
-                           estimatedCamerasParams[i].K(),
-                           calculatedRotation[i],
-                           calculatedTranslation[i],
-                           noArray());
+    {
+      TRACE_SPAN("decomposeHomographyMat", "decomposition");
+      decomposeHomographyMat(homography[i],
+                             estimatedCamerasParams[i].K(),
+                             calculatedRotation[i],
+                             calculatedTranslation[i],
+                             noArray());
+    }
 
-    DEBUG_STREAM("Rotation K() of " << inputImagesPaths[i + 1] << " -> " << inputImagesPaths[i]);
+    LOG_DEBUG("Rotation K() of " << inputImagesPaths[i + 1] << " -> " << inputImagesPaths[i]);
     for (int o = 0; o < calculatedRotation[i].size(); o++) {
-      DEBUG_STREAM(" R[" << o << "] = " << calculatedRotation[i][o]);
+      LOG_DEBUG(" R[" << o << "] = " << calculatedRotation[i][o]);
     }
 
-    DEBUG_STREAM("Translation K() of " << inputImagesPaths[i + 1] << " -> " << inputImagesPaths[i]);
+    LOG_DEBUG("Translation K() of " << inputImagesPaths[i + 1] << " -> " << inputImagesPaths[i]);
     for (int o = 0; o < calculatedTranslation[i].size(); o++) {
-      DEBUG_STREAM(" t[" << o << "]= " << calculatedTranslation[i][o]);
+      LOG_DEBUG(" t[" << o << "]= " << calculatedTranslation[i][o]);
     }
 
     if (!outEnable) {
@@ -611,24 +724,151 @@ void decomoposeHMatrix() {
 }
 
 void createSeqMatchesInfo() {
+  int n = features.size();
+
+  // Pairs without features are never matched and keep the defaults
   for (int i = 0; i < seqMatchesInfo.size(); i++) {
-    seqMatchesInfo[i] = findMatchInfo(pairwiseMatches, i, i + 1);
+    seqMatchesInfo[i] = pairwiseMatches[i * n + i + 1];
+  }
+}
+
+Mat createMatchMask() {
+  int n = features.size();
+  int window = parser->get<int>("match_window");
+  Mat mask(n, n, CV_8U, Scalar(0));
+  stringstream pairs(parser->has("match_pairs") ? parser->get<string>("match_pairs") : "");
+  string pair;
+
+  // No window matches every pair, or only the sequential ones when guided
+  if (window <= 0) {
+    window = guidedMatcher ? 1 : n;
+  }
+
+  for (int i = 0; i < n; i++) {
+    for (int j = i + 1; j < n && j - i <= window; j++) {
+      mask.at<uchar>(i, j) = 1;
+    }
+  }
+
+  // Extra pairs as a comma separated list of <i>:<j>
+  while (getline(pairs, pair, ',')) {
+    int i = -1, j = -1;
+    char sep = 0;
+    stringstream ss(pair);
+
+    if (!(ss >> i >> sep >> j) || sep != ':' || i < 0 || j < 0 || i >= n || j >= n || i == j) {
+      LOG_WARN("Ignoring invalid match pair " << pair);
+      continue;
+    }
+
+    mask.at<uchar>(min(i, j), max(i, j)) = 1;
+  }
+
+  return mask;
+}
+
+void storePairMatches(int from, int to, const MatchesInfo &info) {
+  int n = features.size();
+  MatchesInfo &pair = pairwiseMatches[from * n + to];
+  MatchesInfo &dual = pairwiseMatches[to * n + from];
+
+  // Same layout as FeaturesMatcher, both directions of the pair
+  pair = info;
+  pair.src_img_idx = from;
+  pair.dst_img_idx = to;
+
+  dual = pair;
+  dual.src_img_idx = to;
+  dual.dst_img_idx = from;
+
+  if (!pair.H.empty()) {
+    dual.H = pair.H.inv();
+  }
+
+  for (int i = 0; i < dual.matches.size(); i++) {
+    swap(dual.matches[i].queryIdx, dual.matches[i].trainIdx);
+  }
+}
+
+void matchGuided(const Mat &mask) {
+  TRACE_SPAN("GuidedMatcher", "match");
+  int n = features.size();
+
+  pairwiseMatches.assign(n * n, MatchesInfo());
+  guidedMatcher->setPrediction(Mat());
+
+  for (int i = 0; i < n - 1; i++) {
+    MatchesInfo info;
+
+    // The first pair, or the pair after a lost one, has no prediction
+    if (guidedMatcher->getPrediction().empty()) {
+      (*featuresMatcher)(features[i], features[i + 1], info);
+    } else {
+      (*guidedMatcher)(features[i], features[i + 1], info);
+    }
+
+    // A bad prediction loses the pair, match it exhaustively again
+    if (info.confidence == 0 && !guidedMatcher->getPrediction().empty()) {
+      LOG_DEBUG("Guided matching of " << inputImagesPaths[i] << " -> " << inputImagesPaths[i + 1] << " failed");
+      info = MatchesInfo();
+      (*featuresMatcher)(features[i], features[i + 1], info);
+    }
+
+    storePairMatches(i, i + 1, info);
+
+    // Constant motion, the next pair moves as this one did
+    guidedMatcher->setPrediction(
+        info.confidence == 0 ? Mat() :
+        HomographyFeaturesMatcher::uncentered(info.H, features[i].img_size, features[i + 1].img_size));
+  }
+
+  // Non sequential pairs have no prediction
+  for (int i = 0; i < n; i++) {
+    for (int j = i + 2; j < n; j++) {
+      MatchesInfo info;
+
+      if (!mask.at<uchar>(i, j)) {
+        continue;
+      }
+
+      (*featuresMatcher)(features[i], features[j], info);
+      storePairMatches(i, j, info);
+    }
+  }
+
+  if (parser->has("v")) {
+    guidedMatcher->printStats();
   }
 }
 
 void matchFeatures() {
-  BestOf2NearestMatcher	matcher(false,	match_conf);
+  TRACE_SPAN("matchFeatures", "stage");
   vector<MatchesInfoSerializer> serMatches;
+  int n = features.size();
   FileStorage fs;
 
   if (parser->has("match") || !checkFileExists(featuresFile)) {
-    matcher(features,	pairwiseMatches);
-    matcher.collectGarbage();
+    Mat mask = createMatchMask();
+
+    LOG_DEBUG("Matching " << countNonZero(mask) << " of " << n * (n - 1) / 2 << " pairs");
+
+    if (guidedMatcher) {
+      matchGuided(mask);
+    } else {
+      TRACE_SPAN("FeaturesMatcher", "match");
+      pairwiseMatches.assign(n * n, MatchesInfo());
+      (*featuresMatcher)(features, pairwiseMatches, mask.getUMat(ACCESS_READ));
+    }
 
-    serMatches = vector<MatchesInfoSerializer>(pairwiseMatches.size());
+    featuresMatcher->collectGarbage();
 
+    // Only the matched pairs, the layout is rebuilt from their indexes
     for (int i = 0; i < pairwiseMatches.size(); i++) {
-      serMatches[i] = MatchesInfoSerializer(pairwiseMatches[i]);
+      MatchesInfo &info = pairwiseMatches[i];
+
+      if (info.src_img_idx >= 0 && info.dst_img_idx >= 0 && info.src_img_idx != info.dst_img_idx) {
+        serMatches.push_back(MatchesInfoSerializer(info));
+      }
     }
 
     fs = FileStorage(featuresFile, FileStorage::APPEND);
@@ -644,13 +884,59 @@ void matchFeatures() {
   fs["matches"] >> serMatches;
   fs.release();
 
+  // Same layout as FeaturesMatcher, whether the file holds all the pairs or
+  // only the matched ones
+  pairwiseMatches.assign(n * n, MatchesInfo());
+
   for (int i = 0; i < serMatches.size(); i++) {
-    pairwiseMatches.push_back(*serMatches[i].matches);
+    MatchesInfo &info = *serMatches[i].matches;
+
+    if (info.src_img_idx < 0 || info.dst_img_idx < 0 || info.src_img_idx >= n || info.dst_img_idx >= n) {
+      continue;
+    }
+
+    swap(pairwiseMatches[info.src_img_idx * n + info.dst_img_idx], info);
   }
 
   createSeqMatchesInfo();
 }
 
+void linkTracks() {
+  TRACE_SPAN("linkTracks", "stage");
+  vector<DMatch> inliers;
+
+  trackStore.addFrame(features[0].keypoints, inliers);
+
+  for (int i = 0; i < seqMatchesInfo.size(); i++) {
+    const MatchesInfo &info = seqMatchesInfo[i];
+
+    inliers.clear();
+
+    // Pairs without a homography break every track
+    for (int m = 0; m < info.matches.size() && info.confidence != 0; m++) {
+      if (info.inliers_mask.empty() || info.inliers_mask[m]) {
+        inliers.push_back(info.matches[m]);
+      }
+    }
+
+    trackStore.addFrame(features[i + 1].keypoints, inliers);
+  }
+
+  if (parser->has("v")) {
+    trackStore.printStats();
+  }
+}
+
+void createFrameCache() {
+  string dir = parser->has("cache_dir") ? parser->get<string>("cache_dir") : "";
+
+  if (!dir.empty()) {
+    mkdir(dir.c_str(), S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH);
+  }
+
+  frameCache = makePtr<FrameCache>((size_t)parser->get<int>("cache_mem") * 1024 * 1024, dir);
+}
+
 void createImageOutDir() {
   string dir = "";
   int dir_err = 0;
@@ -670,7 +956,8 @@ int main(int argc, char **argv) {
 
   parser = makePtr<CommandLineParser>(argc, argv, keys);
 
-  Debug::setEnable(parser->has("v"));
+  Log::setLevel(parser->has("v") ? LOG_LEVEL_TRACE : LOG_LEVEL_WARN);
+  Trace::setEnable(parser->has("trace"));
   enableGui = parser->has("show");
   outEnable = parser->has("outdir");
   if (outEnable) {
@@ -685,15 +972,25 @@ int main(int argc, char **argv) {
   versionPrinting();
   parserFinder();
 
-  TRACE_LINE(__FILE__, __LINE__);
+  // Binary descriptors are already compact
+  quantize = parser->has("quantize");
+  if (quantize && parser->get<string>("finder") == "orb") {
+    LOG_WARN("Ignoring quantize with binary descriptors");
+    quantize = false;
+  }
+
+  parserMatcher();
+
+  LOG_POINT();
   parserInputImagesFiles();
   createImageOutDir();
+  createFrameCache();
 
   if (inputImagesPaths.size() <= 1) {
     error(-1, "No enought input files", __FUNCTION__, __FILE__, __LINE__);
   }
 
-  LOG("Initializing Vectors");
+  LOG_DEBUG("Initializing Vectors");
   features = vector<ImageFeatures>(inputImagesPaths.size());
   homography = vector<Mat>(inputImagesPaths.size() - 1);
   seqMatchesInfo = vector<MatchesInfo>(inputImagesPaths.size() - 1);
@@ -705,49 +1002,61 @@ int main(int argc, char **argv) {
   imageCorners.push_back(Point2f(scaled.width, scaled.height));
   imageCorners.push_back(Point2f(0, scaled.height));
 
-  LOG("Detecting Features");
+  LOG_DEBUG("Detecting Features");
   parseFeatures();
 
-  LOG("Matching Features");
+  LOG_DEBUG("Matching Features");
   matchFeatures();
 
-  LOG("Calculate Homography Matrix");
+  LOG_DEBUG("Linking Tracks");
+  linkTracks();
+
+  LOG_DEBUG("Calculate Homography Matrix");
   calcHomographyMatrix();
 
-  LOG("Estimate Camera Parameters");
+  LOG_DEBUG("Estimate Camera Parameters");
   estimateCameraParams();
 
-//  LOG("Adjust Camera Parameters");
+//  LOG_DEBUG("Adjust Camera Parameters");
 //  adjustCameraParams();
 
-  LOG("Decompose Rotational and Translational Matrix");
+  LOG_DEBUG("Decompose Rotational and Translational Matrix");
   decomoposeHMatrix();
 
-  LOG("Testing projection");
+  LOG_DEBUG("Testing projection");
   compareProjectedPoints();
 
 
-  LOG("Create Images");
+  LOG_DEBUG("Create Images");
   createImages();
 
-  LOG("Calculate Running Stats");
+  LOG_DEBUG("Calculate Running Stats");
   for (int i = 0; i < inputImagesPaths.size(); i++) {
     if (seqMatchesInfo[i].confidence == 0) {
       skipped++;
     }
   }
-  DEBUG_STREAM(" * Total images - " << inputImagesPaths.size());
-  DEBUG_STREAM(" * Skipped images - " << skipped);
-  DEBUG_STREAM(" * Skipped ratio - " << ((double)skipped)/((double)inputImagesPaths.size()));
+  LOG_DEBUG(" * Total images - " << inputImagesPaths.size());
+  LOG_DEBUG(" * Skipped images - " << skipped);
+  LOG_DEBUG(" * Skipped ratio - " << ((double)skipped)/((double)inputImagesPaths.size()));
 
 
   t = ((double)getTickCount() - t)/getTickFrequency();
-  DEBUG_STREAM(" * Total Running Time - " << t << "s");
-  DEBUG_STREAM(" * Extract Enable - " << (parser->has("extract") ? "ON" : "OFF"));
-  DEBUG_STREAM(" * Match Enable - " << (parser->has("match") ? "ON" : "OFF"));
-  DEBUG_STREAM(" * Output Enable - " << (outEnable ? "ON" : "OFF"));
-  DEBUG_STREAM(" * Output Path - " << outdir);
-  DEBUG_STREAM(" * GUI Enable - " << (enableGui ? "ON" : "OFF"));
+  LOG_DEBUG(" * Total Running Time - " << t << "s");
+  LOG_DEBUG(" * Extract Enable - " << (parser->has("extract") ? "ON" : "OFF"));
+  LOG_DEBUG(" * Match Enable - " << (parser->has("match") ? "ON" : "OFF"));
+  LOG_DEBUG(" * Output Enable - " << (outEnable ? "ON" : "OFF"));
+  LOG_DEBUG(" * Output Path - " << outdir);
+  LOG_DEBUG(" * GUI Enable - " << (enableGui ? "ON" : "OFF"));
+
+  if (parser->has("v")) {
+    Log::flush();
+    frameCache->printStats();
+  }
+
+  if (parser->has("trace")) {
+    Trace::write(parser->get<string>("trace"));
+  }
 
   return 0;
 }
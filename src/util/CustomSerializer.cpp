@@ -52,7 +52,7 @@
 #include <chrono>
 #include <iostream>
 #include <opencv2/opencv.hpp>
-#include <util/Debug.hpp>
+#include <util/Log.hpp>
 
 using namespace std;
 using namespace cv;
@@ -22,49 +22,50 @@
  * SOFTWARE.
  *
  */
-#include <util/Debug.hpp>
+#include <util/DescriptorQuantizer.hpp>
 
-#define DEBUG_PREPEND "[debug] "
-
-using namespace std;
-
-bool Debug::enable = false;
-stringstream Debug::out("");
+#include <cmath>
 
 /**
- * Set debug enable flag
+ * Fit the scale of a set of float descriptors
  */
-void Debug::setEnable(bool enableVal) { enable = enableVal; }
+float DescriptorQuantizer::fitScale(const vector<Mat> &descriptors) {
+  double largest = 0;
 
-/**
- * Print debug message
- */
-void Debug::printMessage(string message) {
-  if (!enable) {
-    return;
+  for (size_t i = 0; i < descriptors.size(); i++) {
+    double minVal = 0, maxVal = 0;
+
+    if (descriptors[i].empty()) {
+      continue;
+    }
+
+    CV_Assert(descriptors[i].type() == CV_32F);
+
+    minMaxLoc(descriptors[i], &minVal, &maxVal);
+    largest = max(largest, max(std::abs(minVal), std::abs(maxVal)));
   }
 
-  cout << DEBUG_PREPEND << message << endl;
+  return largest > 0 ? (float)(largest / levels) : 1.f;
 }
 
 /**
- * Add debug trace point
+ * Quantize float descriptors
  */
-void Debug::addPoint(string file, int line) {
-  if (!enable) {
-    return;
-  }
+void DescriptorQuantizer::quantize(const Mat &descriptors, float scale,
+                                   Mat &quantized) {
+  CV_Assert(descriptors.empty() || descriptors.type() == CV_32F);
+  CV_Assert(scale > 0);
 
-  cout << DEBUG_PREPEND << file << " (" << line << ")" << endl;
+  // Rounds and saturates
+  descriptors.convertTo(quantized, CV_8S, 1.0 / scale);
 }
 
 /**
- * Add debug trace point
+ * Recover float descriptors from quantized ones
  */
-void Debug::addPoint(string file, int line, string message) {
-  if (!enable) {
-    return;
-  }
+void DescriptorQuantizer::dequantize(const Mat &quantized, float scale,
+                                     Mat &descriptors) {
+  CV_Assert(quantized.empty() || quantized.type() == CV_8S);
 
-  cout << DEBUG_PREPEND << file << " (" << line << ") - " << message << endl;
+  quantized.convertTo(descriptors, CV_32F, scale);
 }
@@ -0,0 +1,137 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Pedro Cuadra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+#include <opencv2/imgproc/imgproc.hpp>
+#include <opencv2/video/tracking.hpp>
+
+#include <util/Frame.hpp>
+#include <util/Log.hpp>
+
+/**
+ * Constructor
+ */
+Frame::Frame(const Mat &image) : image(image), builds(0), reuses(0) {}
+
+/**
+ * Get the original image
+ */
+const Mat &Frame::getImage() const { return this->image; }
+
+/**
+ * Get the gray scale representation
+ */
+const Mat &Frame::getGray() {
+  lock_guard<recursive_mutex> guard(this->lock);
+
+  if (!this->gray.empty()) {
+    this->reuses++;
+    return this->gray;
+  }
+
+  LOG_FUNCTION(__PRETTY_FUNCTION__);
+  this->builds++;
+
+  if (this->image.channels() == 1) {
+    this->gray = this->image;
+  } else {
+    cvtColor(this->image, this->gray, COLOR_BGR2GRAY);
+  }
+
+  return this->gray;
+}
+
+/**
+ * Get the box blurred representation of the frame
+ */
+const Mat &Frame::getBlurred(Size ksize) {
+  lock_guard<recursive_mutex> guard(this->lock);
+
+  Mat &blurredImage = this->blurred[SizeKey(ksize.width, ksize.height)];
+
+  if (!blurredImage.empty()) {
+    this->reuses++;
+    return blurredImage;
+  }
+
+  LOG_FUNCTION(__PRETTY_FUNCTION__);
+  this->builds++;
+
+  blur(this->image, blurredImage, ksize);
+
+  return blurredImage;
+}
+
+/**
+ * Get the Otsu binarization of the box blurred frame
+ */
+const Mat &Frame::getOtsuBinary(Size ksize) {
+  lock_guard<recursive_mutex> guard(this->lock);
+
+  Mat &binaryImage = this->otsuBinary[SizeKey(ksize.width, ksize.height)];
+
+  if (!binaryImage.empty()) {
+    this->reuses++;
+    return binaryImage;
+  }
+
+  LOG_FUNCTION(__PRETTY_FUNCTION__);
+  this->builds++;
+
+  threshold(this->getBlurred(ksize), binaryImage, 0, 255,
+            THRESH_BINARY | THRESH_OTSU);
+
+  return binaryImage;
+}
+
+/**
+ * Get the Lucas-Kanade pyramid of the gray scale representation
+ */
+const vector<Mat> &Frame::getFlowPyramid(Size winSize, int maxLevel) {
+  lock_guard<recursive_mutex> guard(this->lock);
+
+  vector<Mat> &flowPyramid = this->flowPyramids[FlowKey(
+      SizeKey(winSize.width, winSize.height), maxLevel)];
+
+  if (!flowPyramid.empty()) {
+    this->reuses++;
+    return flowPyramid;
+  }
+
+  LOG_FUNCTION(__PRETTY_FUNCTION__);
+  this->builds++;
+
+  buildOpticalFlowPyramid(this->getGray(), flowPyramid, winSize, maxLevel);
+
+  return flowPyramid;
+}
+
+/**
+ * Get the number of derivations computed so far
+ */
+size_t Frame::getBuilds() const { return this->builds; }
+
+/**
+ * Get the number of requests served by an already computed derivation
+ */
+size_t Frame::getReuses() const { return this->reuses; }
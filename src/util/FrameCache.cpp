@@ -0,0 +1,320 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Pedro Cuadra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+#include <util/FrameCache.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+#include <util/Log.hpp>
+#include <util/Trace.hpp>
+
+/** Disk frames header, the pixels start at the next page */
+struct DiskHeader {
+  char magic[8];
+  int64_t sourceSize;
+  int64_t sourceTime;
+  int32_t rows;
+  int32_t cols;
+  int32_t type;
+  uint32_t keyLength;
+};
+
+/** Disk frames magic and format version */
+static const char diskMagic[8] = {'F', 'T', 'F', 'R', 'A', 'M', 'E', '1'};
+/** Bytes before the pixels, header and key included */
+static const size_t diskDataOffset = 4096;
+
+/**
+ * Get the size and modification time of a source file
+ * @param path Source path
+ * @param size File size
+ * @param time Modification time, in nanoseconds
+ * @return true if the file exists
+ */
+static bool sourceStat(const string &path, int64_t &size, int64_t &time) {
+  struct stat info;
+
+  if (stat(path.c_str(), &info) != 0) {
+    return false;
+  }
+
+  size = info.st_size;
+  time = (int64_t)info.st_mtim.tv_sec * 1000000000 + info.st_mtim.tv_nsec;
+
+  return true;
+}
+
+bool FrameCache::Key::operator<(const Key &other) const {
+  if (this->path != other.path) {
+    return this->path < other.path;
+  }
+
+  if (this->width != other.width) {
+    return this->width < other.width;
+  }
+
+  if (this->height != other.height) {
+    return this->height < other.height;
+  }
+
+  return this->flags < other.flags;
+}
+
+string FrameCache::Key::str() const {
+  ostringstream ss;
+
+  ss << this->path << "@" << this->width << "x" << this->height << "/"
+     << this->flags;
+
+  return ss.str();
+}
+
+/**
+ * Constructor
+ */
+FrameCache::FrameCache(size_t memoryCap, const string &diskDir)
+    : memoryCap(memoryCap), diskDir(diskDir) {}
+
+/**
+ * Get a frame, decoding it on a miss
+ */
+Mat FrameCache::get(const string &path, Size size, int flags,
+                    Decoder decode) {
+  Key key = {path, size.width, size.height, flags};
+  Mat image;
+
+  {
+    lock_guard<mutex> guard(this->lock);
+    map<Key, Entries::iterator>::iterator it = this->index.find(key);
+
+    if (it != this->index.end()) {
+      // Most recently used first
+      this->entries.splice(this->entries.begin(), this->entries, it->second);
+      this->memoryHits++;
+      return it->second->second;
+    }
+  }
+
+  // Both tiers are filled outside the lock, threads may race on the same
+  // frame and both decode it
+  if (this->readDisk(key, image)) {
+    lock_guard<mutex> guard(this->lock);
+    this->diskHits++;
+    this->remember(key, image);
+    return image;
+  }
+
+  image = decode();
+
+  if (image.empty()) {
+    return image;
+  }
+
+  this->writeDisk(key, image);
+
+  lock_guard<mutex> guard(this->lock);
+  this->misses++;
+  this->remember(key, image);
+
+  return image;
+}
+
+/**
+ * Get the bytes held by the memory tier
+ */
+size_t FrameCache::getMemoryBytes() {
+  lock_guard<mutex> guard(this->lock);
+
+  return this->memoryBytes;
+}
+
+/**
+ * Print the hits and misses of every tier
+ */
+void FrameCache::printStats() {
+  lock_guard<mutex> guard(this->lock);
+
+  cout << "Frame Cache - Stats: " << endl;
+  cout << "  "
+       << "Memory Hits: " << this->memoryHits << endl;
+  cout << "  "
+       << "Disk Hits: " << this->diskHits << endl;
+  cout << "  "
+       << "Decoded: " << this->misses << endl;
+  cout << "  "
+       << "Memory Held: " << this->memoryBytes / (1024 * 1024) << "MB of "
+       << this->memoryCap / (1024 * 1024) << "MB" << endl;
+}
+
+/**
+ * Insert a frame in the memory tier, lock held
+ */
+void FrameCache::remember(const Key &key, const Mat &image) {
+  size_t bytes = image.total() * image.elemSize();
+
+  // A racing thread may have inserted it already
+  if (bytes > this->memoryCap || this->index.count(key)) {
+    return;
+  }
+
+  while (this->memoryBytes + bytes > this->memoryCap) {
+    const pair<Key, Mat> &oldest = this->entries.back();
+
+    this->memoryBytes -= oldest.second.total() * oldest.second.elemSize();
+    this->index.erase(oldest.first);
+    this->entries.pop_back();
+  }
+
+  this->entries.push_front(make_pair(key, image));
+  this->index[key] = this->entries.begin();
+  this->memoryBytes += bytes;
+}
+
+/**
+ * Get the disk tier file of a frame
+ */
+string FrameCache::diskPath(const Key &key) const {
+  ostringstream ss;
+
+  // Collisions are caught by the key stored in the header
+  ss << this->diskDir << "/" << hex << hash<string>()(key.str()) << ".frame";
+
+  return ss.str();
+}
+
+/**
+ * Read a frame from the disk tier
+ */
+bool FrameCache::readDisk(const Key &key, Mat &image) const {
+  TRACE_SPAN("readDisk", "decode");
+  string name = key.str();
+  int64_t sourceSize = 0, sourceTime = 0;
+  struct stat info;
+  const DiskHeader *header = NULL;
+  void *mapped = MAP_FAILED;
+  bool valid = false;
+  int fd = -1;
+
+  if (this->diskDir.empty() ||
+      !sourceStat(key.path, sourceSize, sourceTime)) {
+    return false;
+  }
+
+  fd = open(this->diskPath(key).c_str(), O_RDONLY);
+
+  if (fd < 0) {
+    return false;
+  }
+
+  if (fstat(fd, &info) == 0 && (size_t)info.st_size >= diskDataOffset) {
+    mapped = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  }
+
+  close(fd);
+
+  if (mapped == MAP_FAILED) {
+    return false;
+  }
+
+  header = (const DiskHeader *)mapped;
+  valid = memcmp(header->magic, diskMagic, sizeof(diskMagic)) == 0 &&
+          header->sourceSize == sourceSize &&
+          header->sourceTime == sourceTime &&
+          header->keyLength == name.size() &&
+          sizeof(DiskHeader) + name.size() <= diskDataOffset &&
+          memcmp(header + 1, name.data(), name.size()) == 0 &&
+          header->rows == key.height && header->cols == key.width;
+
+  if (valid) {
+    Mat mappedImage(header->rows, header->cols, header->type,
+                    (char *)mapped + diskDataOffset);
+
+    valid = diskDataOffset + mappedImage.total() * mappedImage.elemSize() ==
+            (size_t)info.st_size;
+
+    // The mapping doesn't outlive this call
+    if (valid) {
+      mappedImage.copyTo(image);
+    }
+  }
+
+  munmap(mapped, info.st_size);
+
+  return valid;
+}
+
+/**
+ * Write a frame to the disk tier
+ */
+void FrameCache::writeDisk(const Key &key, const Mat &image) const {
+  TRACE_SPAN("writeDisk", "write");
+  string name = key.str();
+  string path = this->diskPath(key);
+  ostringstream tmpPath;
+  vector<char> prefix(diskDataOffset, 0);
+  DiskHeader header;
+  Mat pixels = image.isContinuous() ? image : image.clone();
+  FILE *file = NULL;
+  bool written = false;
+
+  if (this->diskDir.empty() ||
+      sizeof(DiskHeader) + name.size() > diskDataOffset ||
+      !sourceStat(key.path, header.sourceSize, header.sourceTime)) {
+    return;
+  }
+
+  memcpy(header.magic, diskMagic, sizeof(diskMagic));
+  header.rows = pixels.rows;
+  header.cols = pixels.cols;
+  header.type = pixels.type();
+  header.keyLength = name.size();
+  memcpy(&prefix[0], &header, sizeof(header));
+  memcpy(&prefix[sizeof(header)], name.data(), name.size());
+
+  // Written aside and renamed, readers never see a partial frame
+  tmpPath << path << ".tmp" << hex << hash<thread::id>()(this_thread::get_id());
+  file = fopen(tmpPath.str().c_str(), "wb");
+
+  if (!file) {
+    LOG_WARN("Couldn't write cached frame " << tmpPath.str());
+    return;
+  }
+
+  written = fwrite(&prefix[0], 1, prefix.size(), file) == prefix.size() &&
+            fwrite(pixels.data, pixels.elemSize(), pixels.total(), file) ==
+                pixels.total();
+  written = fclose(file) == 0 && written;
+
+  if (!written || rename(tmpPath.str().c_str(), path.c_str()) != 0) {
+    LOG_WARN("Couldn't write cached frame " << path);
+    remove(tmpPath.str().c_str());
+  }
+}
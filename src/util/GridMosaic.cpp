@@ -40,7 +40,7 @@ GridMosaic::GridMosaic(int rows, int cols, string name) {
  * Set an image in the corresponing row and column
  */
 void GridMosaic::setImage(int row, int col, Mat image) {
-  STACK_TRACE(__FUNCTION__);
+  LOG_FUNCTION(__FUNCTION__);
   checkRowCol(row, col);
   assert(!image.empty());
 
@@ -73,14 +73,14 @@ Mat GridMosaic::create() {
     for (int j = 0; j < this->cols; j++) {
       cout << Rect(i * width, j * height, width, height) << endl;
       currentImage = Mat(fullImage, Rect(j * width, i * height, width, height));
-      TRACE_LINE(__FILE__, __LINE__);
+      LOG_POINT();
       // cout << this->images[i][j];
       Mat::zeros(width, height, images[0][0].type());
       this->images[i][j].copyTo(currentImage);
     }
   }
 
-  TRACE_LINE(__FILE__, __LINE__);
+  LOG_POINT();
 
   return fullImage;
 }
@@ -0,0 +1,295 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Pedro Cuadra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+#include <util/HammingDistance.hpp>
+
+#include <cstring>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define HAMMING_X86
+#include <immintrin.h>
+#endif
+
+static const int queryBlock = HammingDistance::queryBlock;
+
+/**
+ * Count the bits set in a 64 bits word
+ */
+static inline int popcount64(uint64_t word) {
+  return __builtin_popcountll(word);
+}
+
+/**
+ * Distance between two descriptors of any length
+ */
+static inline __attribute__((always_inline)) int
+distanceAny(const uint8_t *a, const uint8_t *b, int bytes) {
+  uint64_t wa, wb;
+  int d = 0;
+  int i = 0;
+
+  for (; i + 8 <= bytes; i += 8) {
+    memcpy(&wa, a + i, 8);
+    memcpy(&wb, b + i, 8);
+    d += popcount64(wa ^ wb);
+  }
+
+  for (; i < bytes; i++) {
+    d += popcount64(a[i] ^ b[i]);
+  }
+
+  return d;
+}
+
+/**
+ * Generic length tile loop, inlined so it picks the caller's instructions
+ */
+static inline __attribute__((always_inline)) void
+tileAny(const uint8_t *const *queries, const uint8_t *train, size_t trainStep,
+        int trainRows, int bytes, int *distances) {
+  for (int t = 0; t < trainRows; t++) {
+    for (int b = 0; b < queryBlock; b++) {
+      distances[b * trainRows + t] =
+          distanceAny(queries[b], train + t * trainStep, bytes);
+    }
+  }
+}
+
+/**
+ * Generic length scalar kernel
+ */
+static void tileScalarAny(const uint8_t *const *queries, const uint8_t *train,
+                          size_t trainStep, int trainRows, int bytes,
+                          int *distances) {
+  tileAny(queries, train, trainStep, trainRows, bytes, distances);
+}
+
+/**
+ * Fixed length scalar kernel, the queries stay in registers
+ */
+template <int Bytes>
+static void tileScalar(const uint8_t *const *queries, const uint8_t *train,
+                       size_t trainStep, int trainRows, int, int *distances) {
+  const int words = Bytes / 8;
+  uint64_t q[queryBlock][words];
+  uint64_t w[words];
+
+  for (int b = 0; b < queryBlock; b++) {
+    memcpy(q[b], queries[b], Bytes);
+  }
+
+  for (int t = 0; t < trainRows; t++) {
+    memcpy(w, train + t * trainStep, Bytes);
+
+    for (int b = 0; b < queryBlock; b++) {
+      int d = 0;
+
+      for (int i = 0; i < words; i++) {
+        d += popcount64(q[b][i] ^ w[i]);
+      }
+
+      distances[b * trainRows + t] = d;
+    }
+  }
+}
+
+#ifdef HAMMING_X86
+/**
+ * Generic length kernel using the POPCNT instruction
+ */
+__attribute__((target("popcnt"))) static void
+tilePopcntAny(const uint8_t *const *queries, const uint8_t *train,
+              size_t trainStep, int trainRows, int bytes, int *distances) {
+  tileAny(queries, train, trainStep, trainRows, bytes, distances);
+}
+
+/**
+ * Count the bits set in every byte, nibble lookup through a shuffle
+ */
+__attribute__((target("avx2"))) static inline __m256i popcount8(__m256i v) {
+  const __m256i lut = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2,
+                                       3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3, 1, 2,
+                                       2, 3, 2, 3, 3, 4);
+  const __m256i nibble = _mm256_set1_epi8(0x0f);
+  __m256i low = _mm256_and_si256(v, nibble);
+  __m256i high = _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble);
+
+  return _mm256_add_epi8(_mm256_shuffle_epi8(lut, low),
+                         _mm256_shuffle_epi8(lut, high));
+}
+
+/**
+ * Add the four 64 bits lanes
+ */
+__attribute__((target("avx2"))) static inline int hsum64(__m256i v) {
+  __m128i sum = _mm_add_epi64(_mm256_castsi256_si128(v),
+                              _mm256_extracti128_si256(v, 1));
+
+  return (int)(_mm_cvtsi128_si64(sum) + _mm_extract_epi64(sum, 1));
+}
+
+/**
+ * AVX2 kernel for 32 and 64 bytes descriptors
+ */
+template <int Bytes>
+__attribute__((target("avx2"))) static void
+tileAvx2(const uint8_t *const *queries, const uint8_t *train, size_t trainStep,
+         int trainRows, int, int *distances) {
+  const int regs = Bytes / 32;
+  const __m256i zero = _mm256_setzero_si256();
+  __m256i q[queryBlock][regs];
+  __m256i w[regs];
+
+  for (int b = 0; b < queryBlock; b++) {
+    for (int r = 0; r < regs; r++) {
+      q[b][r] = _mm256_loadu_si256((const __m256i *)(queries[b] + 32 * r));
+    }
+  }
+
+  for (int t = 0; t < trainRows; t++) {
+    const uint8_t *row = train + t * trainStep;
+
+    for (int r = 0; r < regs; r++) {
+      w[r] = _mm256_loadu_si256((const __m256i *)(row + 32 * r));
+    }
+
+    for (int b = 0; b < queryBlock; b++) {
+      // At most 16 bits per byte lane, no overflow
+      __m256i counts = zero;
+
+      for (int r = 0; r < regs; r++) {
+        counts = _mm256_add_epi8(counts,
+                                 popcount8(_mm256_xor_si256(q[b][r], w[r])));
+      }
+
+      distances[b * trainRows + t] = hsum64(_mm256_sad_epu8(counts, zero));
+    }
+  }
+}
+
+/**
+ * AVX-512 VPOPCNTDQ kernel for 32 and 64 bytes descriptors. Runs on 256 bits
+ * vectors, which avoids the frequency drop of the 512 bits ones.
+ */
+template <int Bytes>
+__attribute__((target("avx512f,avx512vl,avx512vpopcntdq"))) static void
+tileAvx512(const uint8_t *const *queries, const uint8_t *train,
+           size_t trainStep, int trainRows, int, int *distances) {
+  const int regs = Bytes / 32;
+  __m256i q[queryBlock][regs];
+  __m256i w[regs];
+
+  for (int b = 0; b < queryBlock; b++) {
+    for (int r = 0; r < regs; r++) {
+      q[b][r] = _mm256_loadu_si256((const __m256i *)(queries[b] + 32 * r));
+    }
+  }
+
+  for (int t = 0; t < trainRows; t++) {
+    const uint8_t *row = train + t * trainStep;
+
+    for (int r = 0; r < regs; r++) {
+      w[r] = _mm256_loadu_si256((const __m256i *)(row + 32 * r));
+    }
+
+    for (int b = 0; b < queryBlock; b++) {
+      __m256i counts = _mm256_popcnt_epi64(_mm256_xor_si256(q[b][0], w[0]));
+
+      for (int r = 1; r < regs; r++) {
+        counts = _mm256_add_epi64(
+            counts, _mm256_popcnt_epi64(_mm256_xor_si256(q[b][r], w[r])));
+      }
+
+      distances[b * trainRows + t] = hsum64(counts);
+    }
+  }
+}
+#endif
+
+/**
+ * Get the best instruction set supported by the running CPU
+ */
+HammingDistance::Isa HammingDistance::bestIsa() {
+#ifdef HAMMING_X86
+  static const Isa isa = [] {
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx512vpopcntdq") &&
+        __builtin_cpu_supports("avx512vl")) {
+      return AVX512;
+    }
+
+    return __builtin_cpu_supports("avx2") ? AVX2 : SCALAR;
+  }();
+
+  return isa;
+#else
+  return SCALAR;
+#endif
+}
+
+/**
+ * Get the tile kernel for a descriptor length
+ */
+HammingDistance::TileKernel HammingDistance::select(int bytes, Isa isa) {
+#ifdef HAMMING_X86
+  if (isa == AVX512 && bytes == 32) {
+    return tileAvx512<32>;
+  }
+
+  if (isa == AVX512 && bytes == 64) {
+    return tileAvx512<64>;
+  }
+
+  if (isa != SCALAR && bytes == 32) {
+    return tileAvx2<32>;
+  }
+
+  if (isa != SCALAR && bytes == 64) {
+    return tileAvx2<64>;
+  }
+
+  // Every CPU with AVX2 has POPCNT
+  if (isa != SCALAR) {
+    return tilePopcntAny;
+  }
+#endif
+
+  if (bytes == 32) {
+    return tileScalar<32>;
+  }
+
+  if (bytes == 64) {
+    return tileScalar<64>;
+  }
+
+  return tileScalarAny;
+}
+
+/**
+ * Reference distance between two descriptors
+ */
+int HammingDistance::distance(const uint8_t *a, const uint8_t *b, int bytes) {
+  return distanceAny(a, b, bytes);
+}
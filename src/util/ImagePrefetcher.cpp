@@ -0,0 +1,110 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Pedro Cuadra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+#include <util/ImagePrefetcher.hpp>
+#include <util/Log.hpp>
+#include <util/Trace.hpp>
+
+/**
+ * Decode images ahead of their consumer in a background thread
+ */
+ImagePrefetcher::ImagePrefetcher(vector<string> paths, int depth,
+                                 size_t memoryCap, int flags)
+    : paths(paths), flags(flags), queue(depth, memoryCap) {
+  this->prefetchEnable = depth > 0;
+
+  if (this->prefetchEnable) {
+    this->decoder = thread(&ImagePrefetcher::run, this);
+  }
+}
+
+/**
+ * Stop decoding and join the decoder thread
+ */
+ImagePrefetcher::~ImagePrefetcher() {
+  this->queue.close();
+
+  if (this->decoder.joinable()) {
+    this->decoder.join();
+  }
+}
+
+/**
+ * Get the next image
+ */
+bool ImagePrefetcher::next(PrefetchedImage &image) {
+  if (this->prefetchEnable) {
+    return this->queue.pop(image);
+  }
+
+  if (this->nextIdx >= this->paths.size()) {
+    return false;
+  }
+
+  image = this->decode(this->nextIdx++);
+
+  return true;
+}
+
+/**
+ * Decode an image
+ */
+ImagePrefetcher::PrefetchedImage ImagePrefetcher::decode(int idx) {
+  PrefetchedImage decoded;
+  TRACE_SPAN("imread", "decode");
+
+  LOG_DEBUG("Reading - " << this->paths[idx]);
+
+  decoded.idx = idx;
+  decoded.image = imread(this->paths[idx], this->flags);
+
+  return decoded;
+}
+
+/**
+ * Decoder thread loop
+ */
+void ImagePrefetcher::run() {
+  PrefetchedImage decoded;
+  size_t bytes = 0;
+
+  for (int idx = 0; idx < this->paths.size(); idx++) {
+    // Room for a frame as big as the last one before decoding, so the
+    // frame being decoded is part of the memory cap
+    if (!this->queue.waitForRoom(bytes)) {
+      return;
+    }
+
+    decoded = this->decode(idx);
+    bytes = decoded.image.total() * decoded.image.elemSize();
+
+    if (!this->queue.push(decoded, bytes)) {
+      return;
+    }
+
+    decoded = PrefetchedImage();
+  }
+
+  this->queue.close();
+}
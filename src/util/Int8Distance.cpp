@@ -0,0 +1,199 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Pedro Cuadra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+#include <util/Int8Distance.hpp>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define INT8_X86
+#include <immintrin.h>
+#endif
+
+static const int queryBlock = Int8Distance::queryBlock;
+
+// The AVX2 kernel reduces the sums of a whole block at once
+static_assert(queryBlock == 4, "AVX2 kernel expects blocks of 4 queries");
+
+/**
+ * Distance between two descriptors of any length, fits an int up to 33000
+ * dimensions
+ */
+static inline __attribute__((always_inline)) int
+distanceAny(const int8_t *a, const int8_t *b, int dims) {
+  int d = 0;
+
+  for (int i = 0; i < dims; i++) {
+    int diff = a[i] - b[i];
+    d += diff * diff;
+  }
+
+  return d;
+}
+
+/**
+ * Generic length scalar kernel
+ */
+static void tileScalarAny(const int8_t *const *queries, const int8_t *train,
+                          size_t trainStep, int trainRows, int dims,
+                          int *distances) {
+  for (int t = 0; t < trainRows; t++) {
+    for (int b = 0; b < queryBlock; b++) {
+      distances[b * trainRows + t] =
+          distanceAny(queries[b], train + t * trainStep, dims);
+    }
+  }
+}
+
+/**
+ * Fixed length scalar kernel, lets the compiler unroll and vectorize
+ */
+template <int Dims>
+static void tileScalar(const int8_t *const *queries, const int8_t *train,
+                       size_t trainStep, int trainRows, int, int *distances) {
+  for (int t = 0; t < trainRows; t++) {
+    const int8_t *row = train + t * trainStep;
+
+    for (int b = 0; b < queryBlock; b++) {
+      distances[b * trainRows + t] = distanceAny(queries[b], row, Dims);
+    }
+  }
+}
+
+#ifdef INT8_X86
+/**
+ * Add the eight 32 bits lanes of four vectors at once
+ * @return the four sums in order
+ */
+__attribute__((target("avx2"))) static inline __m128i
+hsum32x4(__m256i s0, __m256i s1, __m256i s2, __m256i s3) {
+  __m256i sum = _mm256_hadd_epi32(_mm256_hadd_epi32(s0, s1),
+                                  _mm256_hadd_epi32(s2, s3));
+
+  return _mm_add_epi32(_mm256_castsi256_si128(sum),
+                       _mm256_extracti128_si256(sum, 1));
+}
+
+/**
+ * Sign extend 16 elements to 16 bits lanes
+ */
+__attribute__((target("avx2"))) static inline __m256i
+load16(const int8_t *data) {
+  return _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i *)data));
+}
+
+/**
+ * AVX2 kernel for 64 and 128 dimensions descriptors. Differences fit 16
+ * bits lanes and their squares are summed in pairs into 32 bits ones.
+ */
+template <int Dims>
+__attribute__((target("avx2"))) static void
+tileAvx2(const int8_t *const *queries, const int8_t *train, size_t trainStep,
+         int trainRows, int, int *distances) {
+  const int regs = Dims / 16;
+  __m256i q[queryBlock][regs];
+  __m256i w[regs];
+
+  for (int b = 0; b < queryBlock; b++) {
+    for (int r = 0; r < regs; r++) {
+      q[b][r] = load16(queries[b] + 16 * r);
+    }
+  }
+
+  for (int t = 0; t < trainRows; t++) {
+    const int8_t *row = train + t * trainStep;
+
+    for (int r = 0; r < regs; r++) {
+      w[r] = load16(row + 16 * r);
+    }
+
+    __m256i sums[queryBlock];
+
+    for (int b = 0; b < queryBlock; b++) {
+      __m256i diff = _mm256_sub_epi16(q[b][0], w[0]);
+
+      sums[b] = _mm256_madd_epi16(diff, diff);
+
+      for (int r = 1; r < regs; r++) {
+        diff = _mm256_sub_epi16(q[b][r], w[r]);
+        sums[b] = _mm256_add_epi32(sums[b], _mm256_madd_epi16(diff, diff));
+      }
+    }
+
+    __m128i block = hsum32x4(sums[0], sums[1], sums[2], sums[3]);
+
+    distances[t] = _mm_cvtsi128_si32(block);
+    distances[trainRows + t] = _mm_extract_epi32(block, 1);
+    distances[2 * trainRows + t] = _mm_extract_epi32(block, 2);
+    distances[3 * trainRows + t] = _mm_extract_epi32(block, 3);
+  }
+}
+#endif
+
+/**
+ * Get the best instruction set supported by the running CPU
+ */
+Int8Distance::Isa Int8Distance::bestIsa() {
+#ifdef INT8_X86
+  static const Isa isa = [] {
+    __builtin_cpu_init();
+
+    return __builtin_cpu_supports("avx2") ? AVX2 : SCALAR;
+  }();
+
+  return isa;
+#else
+  return SCALAR;
+#endif
+}
+
+/**
+ * Get the tile kernel for a descriptor length
+ */
+Int8Distance::TileKernel Int8Distance::select(int dims, Isa isa) {
+#ifdef INT8_X86
+  if (isa == AVX2 && dims == 64) {
+    return tileAvx2<64>;
+  }
+
+  if (isa == AVX2 && dims == 128) {
+    return tileAvx2<128>;
+  }
+#endif
+
+  if (dims == 64) {
+    return tileScalar<64>;
+  }
+
+  if (dims == 128) {
+    return tileScalar<128>;
+  }
+
+  return tileScalarAny;
+}
+
+/**
+ * Reference squared distance between two descriptors
+ */
+int Int8Distance::distance(const int8_t *a, const int8_t *b, int dims) {
+  return distanceAny(a, b, dims);
+}
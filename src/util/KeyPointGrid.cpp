@@ -0,0 +1,129 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Pedro Cuadra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+#include <cmath>
+
+#include <util/KeyPointGrid.hpp>
+
+/**
+ * Constructor
+ */
+KeyPointGrid::KeyPointGrid(float cellSize)
+    : cellSize(cellSize), cells(0, 0), keypoints(NULL) {
+  CV_Assert(cellSize > 0);
+}
+
+/**
+ * Index a set of keypoints
+ */
+void KeyPointGrid::build(const vector<KeyPoint> &keypoints, Size imageSize) {
+  vector<int> cellIdx(keypoints.size());
+
+  this->keypoints = &keypoints;
+  this->cells.width = max(1, (int)ceil(imageSize.width / this->cellSize));
+  this->cells.height = max(1, (int)ceil(imageSize.height / this->cellSize));
+  this->cellStart.assign(this->cells.area() + 1, 0);
+  this->order.resize(keypoints.size());
+
+  // Counting sort by cell
+  for (size_t i = 0; i < keypoints.size(); i++) {
+    cellIdx[i] = cellOf(keypoints[i].pt.y, this->cells.height) *
+                     this->cells.width +
+                 cellOf(keypoints[i].pt.x, this->cells.width);
+    this->cellStart[cellIdx[i] + 1]++;
+  }
+
+  for (size_t c = 1; c < this->cellStart.size(); c++) {
+    this->cellStart[c] += this->cellStart[c - 1];
+  }
+
+  vector<int> next(this->cellStart.begin(), this->cellStart.end() - 1);
+
+  for (size_t i = 0; i < keypoints.size(); i++) {
+    this->order[next[cellIdx[i]]++] = (int)i;
+  }
+}
+
+/**
+ * Find the indexed keypoints within a radius
+ */
+void KeyPointGrid::radiusSearch(Point2f center, float radius,
+                                vector<int> &indices) const {
+  float radius2 = radius * radius;
+
+  indices.clear();
+
+  if (this->keypoints == NULL) {
+    return;
+  }
+
+  int x0 = cellOf(center.x - radius, this->cells.width);
+  int x1 = cellOf(center.x + radius, this->cells.width);
+  int y0 = cellOf(center.y - radius, this->cells.height);
+  int y1 = cellOf(center.y + radius, this->cells.height);
+
+  for (int y = y0; y <= y1; y++) {
+    for (int x = x0; x <= x1; x++) {
+      int c = y * this->cells.width + x;
+
+      for (int e = this->cellStart[c]; e < this->cellStart[c + 1]; e++) {
+        const Point2f &pt = (*this->keypoints)[this->order[e]].pt;
+        float dx = pt.x - center.x;
+        float dy = pt.y - center.y;
+
+        if (dx * dx + dy * dy <= radius2) {
+          indices.push_back(this->order[e]);
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Get the number of grid cells
+ */
+Size KeyPointGrid::getCells() const { return this->cells; }
+
+/**
+ * Get the number of keypoints in a cell
+ */
+int KeyPointGrid::count(int x, int y) const {
+  int c = y * this->cells.width + x;
+
+  return this->cellStart[c + 1] - this->cellStart[c];
+}
+
+/**
+ * Get the cell column or row of a coordinate
+ */
+int KeyPointGrid::cellOf(float value, int cells) const {
+  // Compare as float first, far away projections would overflow an int
+  float cell = floor(value / this->cellSize);
+
+  if (!(cell > 0)) {
+    return 0;
+  }
+
+  return cell >= cells ? cells - 1 : (int)cell;
+}
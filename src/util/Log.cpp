@@ -0,0 +1,163 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Pedro Cuadra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <util/Log.hpp>
+#include <util/RingBuffer.hpp>
+
+using namespace std;
+
+atomic<int> Log::level(LOG_LEVEL_WARN);
+
+/** Message prefix per level */
+static const char *levelPrefix[] = {"[trace] ", "[debug] ", "[info] ",
+                                    "[warn] ", "[error] "};
+
+/**
+ * Asynchronous log sink
+ *
+ * Producers push formatted messages into a lock-free ring buffer and a
+ * background thread writes them out, so logging threads never wait on the
+ * output stream.
+ */
+class LogSink {
+public:
+  LogSink() : ring(4096), queued(0), written(0), running(true) {
+    this->writer = thread(&LogSink::run, this);
+  }
+
+  ~LogSink() {
+    this->running = false;
+    this->writer.join();
+  }
+
+  /**
+   * Queue a message, waits for a free slot if the buffer is full
+   * @param message Message to be written
+   */
+  void push(string &message) {
+    this->queued++;
+
+    while (!this->ring.push(message)) {
+      this_thread::yield();
+    }
+  }
+
+  /**
+   * Block until every queued message has been written
+   */
+  void flush() {
+    while (this->written.load() < this->queued.load()) {
+      this_thread::yield();
+    }
+  }
+
+private:
+  /** Queued messages */
+  RingBuffer<string> ring;
+  /** Number of queued messages */
+  atomic<size_t> queued;
+  /** Number of written messages */
+  atomic<size_t> written;
+  /** Writer thread running flag */
+  atomic<bool> running;
+  /** Writer thread */
+  thread writer;
+
+  /**
+   * Writer thread loop, drains the buffer before exiting
+   */
+  void run() {
+    string message;
+
+    while (true) {
+      if (this->ring.pop(message)) {
+        cout << message << endl;
+        this->written++;
+        continue;
+      }
+
+      if (!this->running && this->written.load() >= this->queued.load()) {
+        return;
+      }
+
+      this_thread::sleep_for(chrono::milliseconds(1));
+    }
+  }
+};
+
+/**
+ * Get the log sink, created on first use
+ * @return log sink
+ */
+static LogSink &sink() {
+  static LogSink logSink;
+
+  return logSink;
+}
+
+/**
+ * Set the minimum level of the messages to be logged
+ */
+void Log::setLevel(int levelVal) { level = levelVal; }
+
+/**
+ * Get the calling thread's formatting buffer
+ * @return formatting buffer
+ */
+static ostringstream &formatBuffer() {
+  thread_local ostringstream buffer;
+
+  return buffer;
+}
+
+/**
+ * Get the calling thread's formatting buffer, cleared
+ */
+ostringstream &Log::stream() {
+  ostringstream &buffer = formatBuffer();
+
+  buffer.str("");
+  buffer.clear();
+
+  return buffer;
+}
+
+/**
+ * Queue the formatted message
+ */
+void Log::commit(int levelVal) {
+  string message = levelPrefix[levelVal] + formatBuffer().str();
+
+  sink().push(message);
+}
+
+/**
+ * Block until every queued message has been written
+ */
+void Log::flush() { sink().flush(); }
@@ -39,7 +39,7 @@ Mosaic::Mosaic(string name) {
 void Mosaic::setReference(Mat image) {
   Mat A;
 
-  STACK_TRACE(__PRETTY_FUNCTION__);
+  LOG_FUNCTION(__PRETTY_FUNCTION__);
 
   assert(!image.empty());
 
@@ -51,7 +51,7 @@ void Mosaic::setReference(Mat image) {
 }
 
 void Mosaic::setImage(Mat image, Mat M) {
-  STACK_TRACE(__PRETTY_FUNCTION__);
+  LOG_FUNCTION(__PRETTY_FUNCTION__);
 
   assert(!image.empty());
   assert(!M.empty());
@@ -65,7 +65,7 @@ void Mosaic::setImage(Mat image, Mat M) {
 }
 
 void Mosaic::setImage(MosaicImage mosaicImage) {
-  STACK_TRACE(__PRETTY_FUNCTION__);
+  LOG_FUNCTION(__PRETTY_FUNCTION__);
 
   assert(!mosaicImage.image.empty());
   assert(!mosaicImage.m.empty());
@@ -82,7 +82,7 @@ void Mosaic::pushImage(Mat image, Mat M) {
   vector<Mat> Rs;
   vector<Mat> Ts;
 
-  STACK_TRACE(__PRETTY_FUNCTION__);
+  LOG_FUNCTION(__PRETTY_FUNCTION__);
 
   // decomposeHomographyMat(M, cameraMatrix, Rs, Ts, noArray());
 
@@ -112,9 +112,9 @@ void Mosaic::pushImage(Mat image, Mat M) {
 void Mosaic::show() {
   create();
 
-  TRACE_LINE(__FILE__, __LINE__);
+  LOG_POINT();
   imshow(this->name, this->fullImage);
-  TRACE_LINE(__FILE__, __LINE__);
+  LOG_POINT();
 }
 
 void Mosaic::create() {
@@ -126,16 +126,16 @@ void Mosaic::create() {
   Mat mask;
   vector<Point> maskPoints;
 
-  STACK_TRACE(__PRETTY_FUNCTION__);
+  LOG_FUNCTION(__PRETTY_FUNCTION__);
 
   for (int i = 0; i < this->mosaicImages.size(); i++) {
 
-    TRACE_LINE(__FILE__, __LINE__);
+    LOG_POINT();
 
-    LOG("Mosaic Image size:");
-    DEBUG_STREAM(this->mosaicImages[i].image.size());
+    LOG_DEBUG("Mosaic Image size:");
+    LOG_DEBUG(this->mosaicImages[i].image.size());
 
-    TRACE_LINE(__FILE__, __LINE__);
+    LOG_POINT();
 
     // cvtColor(tmpImage, tmpImage, CV_8U);
     // perspectiveTransform(inputImages[i + 1], tmpImage, homography);
@@ -144,7 +144,7 @@ void Mosaic::create() {
       continue;
     }
 
-    TRACE_LINE(__FILE__, __LINE__);
+    LOG_POINT();
 
     inCorners.clear();
 
@@ -157,7 +157,7 @@ void Mosaic::create() {
         Point2f(shiftRight, this->mosaicImages[i].image.rows + shiftDown));
 
     perspectiveTransform(inCorners, outCorners, this->mosaicImages[i].m);
-    DEBUG_STREAM(inCorners << "->" << outCorners);
+    LOG_DEBUG(inCorners << "->" << outCorners);
 
     shiftRight = 0;
     shiftDown = 0;
@@ -172,12 +172,12 @@ void Mosaic::create() {
       }
     }
 
-    LOG("Shift Right");
-    DEBUG_STREAM(shiftRight);
-    LOG("Shift Down");
-    DEBUG_STREAM(shiftDown);
+    LOG_DEBUG("Shift Right");
+    LOG_DEBUG(shiftRight);
+    LOG_DEBUG("Shift Down");
+    LOG_DEBUG(shiftDown);
 
-    TRACE_LINE(__FILE__, __LINE__);
+    LOG_POINT();
 
     maskPoints.clear();
 
@@ -188,16 +188,16 @@ void Mosaic::create() {
       maskPoints.push_back(outCorners[c]);
     }
 
-    DEBUG_STREAM(maskPoints);
+    LOG_DEBUG(maskPoints);
 
-    TRACE_LINE(__FILE__, __LINE__);
+    LOG_POINT();
 
     newSize = Size(fullImage.cols + shiftRight, fullImage.rows + shiftDown);
 
     mask = Mat(newSize.height, newSize.width, CV_8UC1);
     fillConvexPoly(mask, maskPoints, 255, 8, 0);
 
-    TRACE_LINE(__FILE__, __LINE__);
+    LOG_POINT();
 
     inCorners.clear();
     inCorners.push_back(Point2f(0, 0));
@@ -214,14 +214,14 @@ void Mosaic::create() {
 
     shiftTransform = findHomography(inCorners, outCorners, RANSAC);
 
-    DEBUG_STREAM(shiftTransform);
+    LOG_DEBUG(shiftTransform);
 
     warpPerspective(fullImage, fullImage, shiftTransform, newSize);
 
-    TRACE_LINE(__FILE__, __LINE__);
+    LOG_POINT();
 
-    LOG("Full Image size:");
-    DEBUG_STREAM(fullImage.size());
+    LOG_DEBUG("Full Image size:");
+    LOG_DEBUG(fullImage.size());
 
     if (accumulativeShift.empty()) {
       accumulativeShift = shiftTransform;
@@ -236,6 +236,6 @@ void Mosaic::create() {
 
     tmpImage.copyTo(fullImage, mask);
 
-    TRACE_LINE(__FILE__, __LINE__);
+    LOG_POINT();
   }
 }
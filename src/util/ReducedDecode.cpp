@@ -0,0 +1,92 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Pedro Cuadra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+#include <util/ReducedDecode.hpp>
+
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include <util/Log.hpp>
+#include <util/Trace.hpp>
+
+/**
+ * Get the largest decoding reduction keeping an image at least as big as
+ * a target size
+ */
+int ReducedDecode::reductionFor(Size fullSize, Size target) {
+  int reduction = 1;
+
+  // Decoders round the reduced size up
+  while (reduction < 8 &&
+         (fullSize.width + 2 * reduction - 1) / (2 * reduction) >=
+             target.width &&
+         (fullSize.height + 2 * reduction - 1) / (2 * reduction) >=
+             target.height) {
+    reduction *= 2;
+  }
+
+  return reduction;
+}
+
+/**
+ * Get the imread flags of a decoding reduction
+ */
+int ReducedDecode::readFlags(int reduction, int flags) {
+  bool gray = flags == IMREAD_GRAYSCALE;
+
+  switch (reduction) {
+  case 2:
+    return gray ? IMREAD_REDUCED_GRAYSCALE_2 : IMREAD_REDUCED_COLOR_2;
+  case 4:
+    return gray ? IMREAD_REDUCED_GRAYSCALE_4 : IMREAD_REDUCED_COLOR_4;
+  case 8:
+    return gray ? IMREAD_REDUCED_GRAYSCALE_8 : IMREAD_REDUCED_COLOR_8;
+  default:
+    return flags;
+  }
+}
+
+/**
+ * Read an image scaled to a target size
+ */
+Mat ReducedDecode::read(const string &path, Size target, Size fullSize,
+                        int flags) {
+  TRACE_SPAN("imread", "decode");
+  int reduction = fullSize.area() > 0 ? reductionFor(fullSize, target) : 1;
+  Mat image = imread(path, readFlags(reduction, flags));
+
+  // Wrong expected size, the reduction went below the target
+  if (reduction > 1 && !image.empty() &&
+      (image.cols < target.width || image.rows < target.height)) {
+    LOG_WARN(path << " is smaller than expected, decoding it in full");
+    image = imread(path, flags);
+  }
+
+  if (image.empty() || image.size() == target) {
+    return image;
+  }
+
+  resize(image, image, target);
+
+  return image;
+}
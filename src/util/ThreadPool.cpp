@@ -0,0 +1,142 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Pedro Cuadra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+#include <util/ThreadPool.hpp>
+
+/**
+ * Fixed size worker pool
+ */
+ThreadPool::ThreadPool(int threads) {
+  if (threads < 1) {
+    threads = 1;
+  }
+
+  for (int i = 0; i < threads; i++) {
+    this->workers.push_back(thread(&ThreadPool::run, this));
+  }
+}
+
+/**
+ * Wait for the pending tasks and join the workers
+ */
+ThreadPool::~ThreadPool() {
+  // Unclaimed task exceptions are dropped, a destructor can't throw
+  {
+    unique_lock<mutex> guard(this->lock);
+    this->waitIdle(guard);
+    this->stopping = true;
+  }
+
+  this->taskReady.notify_all();
+
+  for (size_t i = 0; i < this->workers.size(); i++) {
+    this->workers[i].join();
+  }
+}
+
+/**
+ * Queue a task to be run by one of the workers
+ */
+void ThreadPool::push(function<void()> task) {
+  {
+    unique_lock<mutex> guard(this->lock);
+    this->tasks.push(task);
+    this->pending++;
+  }
+
+  this->taskReady.notify_one();
+}
+
+/**
+ * Block until every queued task has finished
+ */
+void ThreadPool::wait() {
+  unique_lock<mutex> guard(this->lock);
+  exception_ptr failure;
+
+  this->waitIdle(guard);
+  swap(failure, this->failure);
+
+  if (failure) {
+    rethrow_exception(failure);
+  }
+}
+
+/**
+ * Block until every queued task has finished, lock held
+ */
+void ThreadPool::waitIdle(unique_lock<mutex> &guard) {
+  this->allDone.wait(guard, [this] { return this->pending == 0; });
+}
+
+/**
+ * Get the number of worker threads
+ */
+int ThreadPool::size() const { return this->workers.size(); }
+
+/**
+ * Worker thread loop
+ */
+void ThreadPool::run() {
+  function<void()> task;
+
+  while (true) {
+    {
+      unique_lock<mutex> guard(this->lock);
+
+      this->taskReady.wait(guard, [this] {
+        return this->stopping || !this->tasks.empty();
+      });
+
+      if (this->tasks.empty()) {
+        return;
+      }
+
+      task = this->tasks.front();
+      this->tasks.pop();
+    }
+
+    exception_ptr failure;
+
+    try {
+      task();
+    } catch (...) {
+      failure = current_exception();
+    }
+
+    {
+      unique_lock<mutex> guard(this->lock);
+
+      if (failure && !this->failure) {
+        this->failure = failure;
+      }
+
+      this->pending--;
+
+      if (this->pending == 0) {
+        this->allDone.notify_all();
+      }
+    }
+  }
+}
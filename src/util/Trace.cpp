@@ -0,0 +1,135 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Pedro Cuadra
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+#include <atomic>
+#include <fstream>
+
+#include <util/Trace.hpp>
+
+bool Trace::enable = false;
+steady_clock::time_point Trace::origin = steady_clock::now();
+vector<Trace::Event> Trace::events;
+mutex Trace::lock;
+
+/**
+ * Escape a string to be written as a JSON string
+ * @param str String to escape
+ * @return escaped string
+ */
+static string jsonEscape(const string &str) {
+  string escaped;
+
+  for (size_t i = 0; i < str.size(); i++) {
+    if (str[i] == '"' || str[i] == '\\') {
+      escaped += '\\';
+    }
+
+    escaped += str[i];
+  }
+
+  return escaped;
+}
+
+/**
+ * Set trace enable flag
+ */
+void Trace::setEnable(bool enableVal) {
+  lock_guard<mutex> guard(lock);
+
+  enable = enableVal;
+  origin = steady_clock::now();
+  events.clear();
+}
+
+/**
+ * Get the current trace time
+ */
+long long Trace::now() {
+  return duration_cast<microseconds>(steady_clock::now() - origin).count();
+}
+
+/**
+ * Record a finished span
+ */
+void Trace::record(const Event &event) {
+  lock_guard<mutex> guard(lock);
+
+  events.push_back(event);
+}
+
+/**
+ * Write the recorded spans in Chrome trace event format
+ */
+void Trace::write(string path) {
+  lock_guard<mutex> guard(lock);
+  ofstream outFile(path);
+
+  outFile << "{\"traceEvents\":[" << endl;
+
+  for (size_t i = 0; i < events.size(); i++) {
+    outFile << "{\"name\":\"" << jsonEscape(events[i].name) << "\","
+            << "\"cat\":\"" << jsonEscape(events[i].category) << "\","
+            << "\"ph\":\"X\","
+            << "\"ts\":" << events[i].begin << ","
+            << "\"dur\":" << events[i].duration << ","
+            << "\"pid\":1,"
+            << "\"tid\":" << events[i].thread << "}"
+            << (i + 1 < events.size() ? "," : "") << endl;
+  }
+
+  outFile << "],\"displayTimeUnit\":\"ms\"}" << endl;
+}
+
+/**
+ * Get a small identifier of the calling thread
+ */
+int Trace::threadId() {
+  static atomic<int> nextId(0);
+  thread_local int id = nextId++;
+
+  return id;
+}
+
+/**
+ * Start recording the span
+ */
+void TraceSpan::start(const string &name, const char *category) {
+  this->event.name = name;
+  this->event.category = category;
+  this->event.thread = Trace::threadId();
+  this->event.begin = Trace::now();
+  this->active = true;
+}
+
+/**
+ * Record the span
+ */
+TraceSpan::~TraceSpan() {
+  if (!this->active) {
+    return;
+  }
+
+  this->event.duration = Trace::now() - this->event.begin;
+  Trace::record(this->event);
+}
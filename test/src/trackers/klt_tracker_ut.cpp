@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include <trackers/KltTracker.hpp>
+
+static String keys = "{show | | Display images }";
+
+/**
+ * Detector counting its runs
+ */
+class CountingDetector : public Feature2D {
+public:
+  int runs = 0;
+
+  void detect(InputArray image, vector<KeyPoint> &keypoints,
+              InputArray mask = noArray()) {
+    this->runs++;
+    this->detector->detect(image, keypoints, mask);
+  }
+
+private:
+  Ptr<Feature2D> detector = GFTTDetector::create(1000, 0.01, 8);
+};
+
+static Mat texture() {
+  Mat image(240, 320, CV_8UC1);
+
+  randu(image, Scalar::all(0), Scalar::all(255));
+  GaussianBlur(image, image, Size(5, 5), 1.5);
+
+  return image;
+}
+
+static Mat shifted(const Mat &image, float dx, float dy) {
+  Mat motion = (Mat_<double>(2, 3) << 1, 0, dx, 0, 1, dy);
+  Mat result;
+
+  warpAffine(image, result, motion, image.size());
+
+  return result;
+}
+
+static float median(vector<float> values) {
+  nth_element(values.begin(), values.begin() + values.size() / 2,
+              values.end());
+
+  return values[values.size() / 2];
+}
+
+TEST(klt_tracker_ut, recovers_translation) {
+  const char *argv[] = {"klt_tracker_ut"};
+  CommandLineParser parser(1, argv, keys);
+  KltTracker tracker(parser, "Test", GFTTDetector::create(1000, 0.01, 8));
+  Mat image = texture();
+  vector<Point2f> p1, p2;
+  vector<float> dx, dy;
+
+  tracker.track(image, 0, shifted(image, 5, 3), 1);
+  tracker.matchesToPoints(p1, p2);
+
+  // The first points belong to the second image
+  ASSERT_GT(p1.size(), 100u);
+  for (size_t i = 0; i < p1.size(); i++) {
+    dx.push_back(p1[i].x - p2[i].x);
+    dy.push_back(p1[i].y - p2[i].y);
+  }
+
+  EXPECT_NEAR(median(dx), 5, 0.1);
+  EXPECT_NEAR(median(dy), 3, 0.1);
+}
+
+TEST(klt_tracker_ut, redetects_below_min_tracks) {
+  const char *argv[] = {"klt_tracker_ut"};
+  CommandLineParser parser(1, argv, keys);
+  Ptr<CountingDetector> detector = makePtr<CountingDetector>();
+  KltTracker::Params params;
+  Mat image = texture();
+  Mat blank(image.size(), image.type(), Scalar::all(128));
+
+  params.maxTracks = 200;
+  params.minTracks = 50;
+  params.minCoverage = 0;
+  KltTracker tracker(parser, "Test", detector, params);
+
+  tracker.track(image, 0, shifted(image, 2, 1), 1);
+  EXPECT_EQ(detector->runs, 1);
+
+  // Enough tracks carried over
+  tracker.track(shifted(image, 2, 1), 1, shifted(image, 4, 2), 2);
+  EXPECT_EQ(detector->runs, 1);
+
+  // Nothing survives a blank frame, the next pair starts from scratch
+  tracker.track(shifted(image, 4, 2), 2, blank, 3);
+  EXPECT_EQ(detector->runs, 1);
+
+  tracker.track(blank, 3, image, 4);
+  EXPECT_EQ(detector->runs, 2);
+
+  // An unknown frame id never carries tracks over
+  tracker.track(image, 5, shifted(image, 2, 1), 6);
+  EXPECT_EQ(detector->runs, 3);
+}
@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include <trackers/MatchFilter.hpp>
+#include <trackers/Tracker.hpp>
+
+static MatchContext emptyContext() {
+  MatchContext context;
+
+  context.keypoints[0] = context.keypoints[1] = NULL;
+  context.descriptors[0] = context.descriptors[1] = NULL;
+  context.knnMatches = context.reverseKnnMatches = NULL;
+
+  return context;
+}
+
+TEST(match_filter_ut, distance_keeps_order) {
+  DistanceFilter filter(0.5);
+  MatchContext context = emptyContext();
+  vector<DMatch> matches;
+
+  matches.push_back(DMatch(0, 0, 10));
+  matches.push_back(DMatch(1, 1, 0));
+  matches.push_back(DMatch(2, 2, 6));
+  matches.push_back(DMatch(3, 3, 4));
+
+  filter.filter(context, matches);
+
+  ASSERT_EQ(matches.size(), 2);
+  EXPECT_EQ(matches[0].queryIdx, 1);
+  EXPECT_EQ(matches[1].queryIdx, 3);
+}
+
+TEST(match_filter_ut, ratio_test) {
+  RatioTestFilter filter(0.8);
+  MatchContext context = emptyContext();
+  vector<vector<DMatch>> knn(3);
+  vector<DMatch> matches;
+
+  knn[0].push_back(DMatch(0, 0, 1));
+  knn[0].push_back(DMatch(0, 1, 10));
+  knn[1].push_back(DMatch(1, 1, 9));
+  knn[1].push_back(DMatch(1, 2, 10));
+  knn[2].push_back(DMatch(2, 2, 5));
+  context.knnMatches = &knn;
+
+  for (size_t i = 0; i < knn.size(); i++) {
+    matches.push_back(knn[i][0]);
+  }
+
+  filter.filter(context, matches);
+
+  ASSERT_EQ(matches.size(), 2);
+  EXPECT_EQ(matches[0].queryIdx, 0);
+  EXPECT_EQ(matches[1].queryIdx, 2);
+}
+
+TEST(match_filter_ut, neighbours) {
+  EXPECT_EQ(RatioTestFilter().getNeighbours(), 2);
+  EXPECT_EQ(CrossCheckFilter().getNeighbours(), 1);
+  EXPECT_EQ(DistanceFilter(0.5).getNeighbours(), 1);
+  EXPECT_EQ(GridMotionFilter().getNeighbours(), 1);
+}
+
+TEST(match_filter_ut, grid_motion_rejects_outliers) {
+  GridMotionFilter filter(10);
+  MatchContext context = emptyContext();
+  vector<KeyPoint> kp0, kp1;
+  vector<DMatch> matches;
+  RNG rng(1);
+  size_t consistent = 0;
+
+  // A dense patch moving by whole cells plus a few random outliers
+  for (int i = 0; i < 200; i++) {
+    Point2f pt(rng.uniform(200.f, 299.f), rng.uniform(200.f, 299.f));
+    kp0.push_back(KeyPoint(pt, 1));
+    kp1.push_back(KeyPoint(pt + Point2f(300, 100), 1));
+  }
+
+  for (int i = 0; i < 10; i++) {
+    kp0.push_back(
+        KeyPoint(rng.uniform(0.f, 1000.f), rng.uniform(0.f, 1000.f), 1));
+    kp1.push_back(
+        KeyPoint(rng.uniform(0.f, 1000.f), rng.uniform(0.f, 1000.f), 1));
+  }
+
+  for (int i = 0; i < kp0.size(); i++) {
+    matches.push_back(DMatch(i, i, 0));
+  }
+
+  context.keypoints[0] = &kp0;
+  context.keypoints[1] = &kp1;
+  context.imageSize[0] = context.imageSize[1] = Size(1000, 1000);
+
+  filter.filter(context, matches);
+
+  for (size_t i = 0; i < matches.size(); i++) {
+    consistent += matches[i].queryIdx < 200;
+  }
+
+  EXPECT_EQ(consistent, 200);
+  EXPECT_EQ(matches.size(), consistent);
+}
+
+TEST(match_filter_ut, ratio_test_with_cross_check_matcher) {
+  const char *argv[] = {"match_filter_ut"};
+  CommandLineParser parser(1, argv, "{show | | Display images }");
+  Ptr<Feature2D> orb = ORB::create(500);
+  Tracker tracker(parser, "Test", orb,
+                  makePtr<BFMatcher>(NORM_HAMMING, true));
+  Mat img1(240, 320, CV_8UC1), img2, desc1, desc2;
+  Mat motion = (Mat_<double>(2, 3) << 1, 0, 4, 0, 1, 2);
+  vector<KeyPoint> kp1, kp2;
+  vector<Point2f> p1, p2;
+  vector<DMatch> crossChecked;
+
+  randu(img1, Scalar::all(0), Scalar::all(255));
+  GaussianBlur(img1, img1, Size(5, 5), 1.5);
+  warpAffine(img1, img2, motion, img1.size());
+
+  tracker.addFilter(makePtr<RatioTestFilter>());
+  ASSERT_NO_THROW(tracker.track(img1, img2));
+  tracker.matchesToPoints(p1, p2);
+
+  // Every match survives the cross-check of the matcher itself
+  orb->detectAndCompute(img1, noArray(), kp1, desc1);
+  orb->detectAndCompute(img2, noArray(), kp2, desc2);
+  BFMatcher(NORM_HAMMING, true).match(desc1, desc2, crossChecked);
+
+  ASSERT_GT(p1.size(), 0u);
+  for (size_t i = 0; i < p1.size(); i++) {
+    bool found = false;
+
+    for (size_t m = 0; m < crossChecked.size() && !found; m++) {
+      found = kp1[crossChecked[m].queryIdx].pt == p2[i] &&
+              kp2[crossChecked[m].trainIdx].pt == p1[i];
+    }
+
+    EXPECT_TRUE(found);
+  }
+}
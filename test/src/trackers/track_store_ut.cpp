@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include <trackers/TrackStore.hpp>
+
+/**
+ * Keypoints along a row, one per x coordinate
+ */
+static vector<KeyPoint> rowKeypoints(int count, float y) {
+  vector<KeyPoint> keypoints;
+
+  for (int i = 0; i < count; i++) {
+    keypoints.push_back(KeyPoint((float)i, y, 1));
+  }
+
+  return keypoints;
+}
+
+TEST(track_store_ut, links_across_frames) {
+  TrackStore store;
+  vector<DMatch> matches;
+  vector<int> frames, keypoints;
+  vector<Point2f> points;
+
+  store.addFrame(rowKeypoints(4, 0), matches);
+
+  // Keypoint 1 moves to 2, keypoint 3 to 0
+  matches.push_back(DMatch(1, 2, 0));
+  matches.push_back(DMatch(3, 0, 0));
+  store.addFrame(rowKeypoints(4, 1), matches);
+
+  int64_t first = store.trackOf(2);
+  int64_t second = store.trackOf(0);
+
+  EXPECT_GE(first, 0);
+  EXPECT_GE(second, 0);
+  EXPECT_NE(first, second);
+  EXPECT_EQ(store.trackOf(1), -1);
+  EXPECT_THROW(store.trackOf(4), cv::Exception);
+  EXPECT_THROW(store.trackOf(-1), cv::Exception);
+
+  // Only the first track continues
+  matches.assign(1, DMatch(2, 3, 0));
+  store.addFrame(rowKeypoints(4, 2), matches);
+
+  EXPECT_EQ(store.trackOf(3), first);
+  EXPECT_EQ(store.frameCount(), 3);
+
+  ASSERT_TRUE(store.getTrack(first, frames, keypoints, points));
+  EXPECT_EQ(frames, vector<int>({0, 1, 2}));
+  EXPECT_EQ(keypoints, vector<int>({1, 2, 3}));
+  EXPECT_EQ(points[2].y, 2);
+
+  vector<int64_t> ids;
+  store.retiredTracks(ids);
+  EXPECT_EQ(ids, vector<int64_t>({second}));
+
+  // Retired tracks are forgotten one frame later
+  store.addFrame(rowKeypoints(4, 3), vector<DMatch>());
+  EXPECT_FALSE(store.getTrack(second, frames, keypoints, points));
+  EXPECT_TRUE(store.getTrack(first, frames, keypoints, points));
+}
+
+TEST(track_store_ut, bounded_observations) {
+  TrackStore store(8);
+  vector<DMatch> matches(1, DMatch(0, 0, 0));
+  vector<int> frames, keypoints;
+  vector<Point2f> points;
+
+  store.addFrame(rowKeypoints(1, 0), vector<DMatch>());
+
+  for (int f = 1; f < 20; f++) {
+    store.addFrame(rowKeypoints(1, f), matches);
+  }
+
+  // A single track through every frame, only the last 8 observations kept
+  ASSERT_TRUE(store.getTrack(store.trackOf(0), frames, keypoints, points));
+  EXPECT_EQ(frames.size(), 8u);
+  EXPECT_EQ(frames.front(), 12);
+  EXPECT_EQ(frames.back(), 19);
+}
@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <stdexcept>
+
+#include <trackers/Tracker.hpp>
+
+static String keys = "{show | | Display images }";
+
+/**
+ * Tracker failing to extract a given frame
+ */
+class FailingTracker : public Tracker {
+public:
+  int extractions = 0;
+
+  FailingTracker(CommandLineParser parser, int failAt)
+      : Tracker(parser, "Test", ORB::create(500),
+                makePtr<BFMatcher>(NORM_HAMMING)),
+        failAt(failAt) {}
+
+protected:
+  virtual void extractFrame(const Mat &image, vector<KeyPoint> &keypoints,
+                            Mat &descriptors) {
+    if (this->extractions++ == this->failAt) {
+      throw runtime_error("extraction failed");
+    }
+
+    Tracker::extractFrame(image, keypoints, descriptors);
+  }
+
+private:
+  int failAt;
+};
+
+/**
+ * Source of random frames, throwing once the given frame is reached
+ */
+static Tracker::FrameSource frames(int count, int failAt) {
+  auto next = make_shared<int>(0);
+
+  return [count, failAt, next](Mat &frame) {
+    if (*next == failAt) {
+      throw runtime_error("read failed");
+    }
+
+    if ((*next)++ >= count) {
+      return false;
+    }
+
+    frame.create(240, 320, CV_8UC1);
+    randu(frame, Scalar::all(0), Scalar::all(255));
+    return true;
+  };
+}
+
+TEST(tracker_ut, sequence_uses_extract_hook) {
+  const char *argv[] = {"tracker_ut"};
+  CommandLineParser parser(1, argv, keys);
+
+  for (size_t depth = 0; depth < 3; depth++) {
+    FailingTracker tracker(parser, -1);
+    int pairs = 0;
+
+    // Every frame is extracted once
+    tracker.setSequential(true);
+    tracker.trackSequence(frames(5, -1), [&pairs](int) { pairs++; }, depth);
+
+    EXPECT_EQ(pairs, 4);
+    EXPECT_EQ(tracker.extractions, 5);
+  }
+}
+
+TEST(tracker_ut, sequence_rethrows_failures) {
+  const char *argv[] = {"tracker_ut"};
+  CommandLineParser parser(1, argv, keys);
+
+  for (size_t depth = 0; depth < 3; depth++) {
+    FailingTracker reading(parser, -1);
+    FailingTracker extracting(parser, 2);
+
+    EXPECT_THROW(reading.trackSequence(frames(5, 3), [](int) {}, depth),
+                 runtime_error);
+    EXPECT_THROW(extracting.trackSequence(frames(5, -1), [](int) {}, depth),
+                 runtime_error);
+  }
+}
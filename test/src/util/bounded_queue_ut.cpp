@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <util/BoundedQueue.hpp>
+
+TEST(bounded_queue_ut, fifo_order) {
+  BoundedQueue<int> queue(4);
+  int item = 0;
+
+  for (int i = 0; i < 4; i++) {
+    EXPECT_TRUE(queue.push(i));
+  }
+
+  for (int i = 0; i < 4; i++) {
+    EXPECT_TRUE(queue.pop(item));
+    EXPECT_EQ(item, i);
+  }
+}
+
+TEST(bounded_queue_ut, drains_after_close) {
+  BoundedQueue<int> queue(2);
+  int item = 0;
+
+  queue.push(7);
+  queue.close();
+
+  EXPECT_FALSE(queue.push(8));
+  EXPECT_TRUE(queue.pop(item));
+  EXPECT_EQ(item, 7);
+  EXPECT_FALSE(queue.pop(item));
+}
+
+TEST(bounded_queue_ut, cost_capacity) {
+  BoundedQueue<int> queue(10, 100);
+  int item = 0;
+
+  // A single item is always accepted regardless of its cost
+  EXPECT_TRUE(queue.push(1, 150));
+  EXPECT_EQ(queue.cost(), 150);
+
+  thread producer([&queue] { queue.push(2, 50); });
+
+  EXPECT_TRUE(queue.pop(item));
+  EXPECT_EQ(item, 1);
+
+  producer.join();
+
+  EXPECT_EQ(queue.size(), 1);
+  EXPECT_EQ(queue.cost(), 50);
+}
+
+TEST(bounded_queue_ut, producer_consumer) {
+  BoundedQueue<int> queue(3);
+  int item = 0;
+  int expected = 0;
+
+  thread producer([&queue] {
+    for (int i = 0; i < 1000; i++) {
+      queue.push(i);
+    }
+
+    queue.close();
+  });
+
+  while (queue.pop(item)) {
+    EXPECT_EQ(item, expected++);
+  }
+
+  producer.join();
+
+  EXPECT_EQ(expected, 1000);
+}
+
+TEST(bounded_queue_ut, wait_for_room) {
+  BoundedQueue<int> queue(4, 100);
+  atomic<bool> roomy(false);
+  int item = 0;
+
+  queue.push(1, 60);
+
+  thread producer([&queue, &roomy] {
+    roomy = queue.waitForRoom(60);
+  });
+
+  // Blocked until the first item leaves
+  this_thread::sleep_for(chrono::milliseconds(20));
+  EXPECT_FALSE(roomy);
+
+  EXPECT_TRUE(queue.pop(item));
+  producer.join();
+  EXPECT_TRUE(roomy);
+
+  queue.close();
+  EXPECT_FALSE(queue.waitForRoom(0));
+}
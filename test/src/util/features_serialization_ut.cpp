@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 
 #include <util/CustomSerializer.hpp>
+#include <util/DescriptorQuantizer.hpp>
 #include <util/TestUtil.hpp>
 
 static const string featuresFile = "testFile.yml";
@@ -66,3 +67,33 @@ TEST(features_serialization_ut, feature_list) {
     checkFeature(feature[i], readFeature[i]);
   }
 }
+
+TEST(features_serialization_ut, quantized_descriptors) {
+  string filename = "quantized_" + featuresFile;
+  ImageFeatures feature, readFeature;
+  ImageFeaturesSerializer readData(readFeature);
+  Mat desc(50, 64, CV_32F), quantized, recovered;
+  float scale = 0;
+  FileStorage fs;
+
+  randu(desc, Scalar(-0.5), Scalar(0.5));
+  scale = DescriptorQuantizer::fitScale(vector<Mat>(1, desc));
+  DescriptorQuantizer::quantize(desc, scale, quantized);
+  quantized.copyTo(feature.descriptors);
+
+  fs = FileStorage(filename, FileStorage::WRITE);
+  fs << "feature" << ImageFeaturesSerializer(feature);
+  fs.release();
+
+  fs = FileStorage(filename, FileStorage::READ);
+  fs["feature"] >> readData;
+  fs.release();
+
+  EXPECT_EQ(readFeature.descriptors.type(), CV_8S);
+  EXPECT_EQ(norm(readFeature.descriptors, feature.descriptors, NORM_INF), 0);
+
+  // Rounding moves every component by half a step at most
+  DescriptorQuantizer::dequantize(readFeature.descriptors.getMat(ACCESS_READ),
+                                  scale, recovered);
+  EXPECT_LE(norm(recovered, desc, NORM_INF), scale / 2 + 1e-6);
+}
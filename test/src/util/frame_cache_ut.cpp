@@ -0,0 +1,44 @@
+#include <gtest/gtest.h>
+
+#include <sys/stat.h>
+
+#include <opencv2/imgcodecs.hpp>
+
+#include <util/FrameCache.hpp>
+
+TEST(frame_cache_ut, memory_and_disk_tiers) {
+  string source = "frame_cache_source.png";
+  string dir = "frame_cache_ut";
+  Mat frame(30, 40, CV_8UC3);
+  int decodes = 0;
+  FrameCache::Decoder decode = [&frame, &decodes] {
+    decodes++;
+    return frame.clone();
+  };
+
+  randu(frame, Scalar::all(0), Scalar::all(255));
+  imwrite(source, frame);
+  mkdir(dir.c_str(), S_IRWXU);
+
+  {
+    // Room for a single frame
+    FrameCache cache(frame.total() * frame.elemSize(), dir);
+
+    Mat first = cache.get(source, frame.size(), IMREAD_COLOR, decode);
+    Mat again = cache.get(source, frame.size(), IMREAD_COLOR, decode);
+    EXPECT_EQ(decodes, 1);
+    EXPECT_EQ(first.data, again.data);
+
+    // Another color mode is another frame, and evicts the first
+    cache.get(source, frame.size(), IMREAD_GRAYSCALE, decode);
+    EXPECT_EQ(decodes, 2);
+    EXPECT_EQ(cache.getMemoryBytes(), frame.total() * frame.elemSize());
+  }
+
+  // A new cache, as a later run, reads the disk tier
+  FrameCache cache(0, dir);
+  Mat cached = cache.get(source, frame.size(), IMREAD_COLOR, decode);
+
+  EXPECT_EQ(decodes, 2);
+  EXPECT_EQ(norm(cached, frame, NORM_INF), 0);
+}
@@ -0,0 +1,33 @@
+#include <gtest/gtest.h>
+
+#include <opencv2/video/tracking.hpp>
+
+#include <util/Frame.hpp>
+
+TEST(frame_ut, flow_pyramid_built_once) {
+  Mat image(240, 320, CV_8UC3);
+  vector<Mat> expected;
+
+  randu(image, Scalar::all(0), Scalar::all(255));
+  Frame frame(image);
+
+  const vector<Mat> &pyramid = frame.getFlowPyramid(Size(21, 21), 3);
+  size_t builds = frame.getBuilds();
+
+  // Gray image and pyramid
+  EXPECT_EQ(builds, 2u);
+  EXPECT_EQ(&frame.getFlowPyramid(Size(21, 21), 3), &pyramid);
+  EXPECT_EQ(frame.getBuilds(), builds);
+  EXPECT_GE(frame.getReuses(), 1u);
+
+  buildOpticalFlowPyramid(frame.getGray(), expected, Size(21, 21), 3);
+  ASSERT_EQ(pyramid.size(), expected.size());
+
+  for (size_t i = 0; i < expected.size(); i++) {
+    EXPECT_EQ(norm(pyramid[i], expected[i], NORM_INF), 0);
+  }
+
+  // Other windows get their own pyramid
+  frame.getFlowPyramid(Size(15, 15), 3);
+  EXPECT_EQ(frame.getBuilds(), builds + 1);
+}
@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include <util/HammingDistance.hpp>
+
+static void checkKernel(int bytes, HammingDistance::Isa isa) {
+  const int rows = 37;
+  const int block = HammingDistance::queryBlock;
+  vector<uint8_t> queries(block * bytes), train(rows * bytes);
+  vector<int> distances(block * rows);
+  const uint8_t *queryRows[block];
+
+  for (size_t i = 0; i < queries.size(); i++) {
+    queries[i] = rand();
+  }
+
+  for (size_t i = 0; i < train.size(); i++) {
+    train[i] = rand();
+  }
+
+  for (int b = 0; b < block; b++) {
+    queryRows[b] = &queries[b * bytes];
+  }
+
+  HammingDistance::select(bytes, isa)(queryRows, &train[0], bytes, rows, bytes,
+                                      &distances[0]);
+
+  for (int b = 0; b < block; b++) {
+    for (int t = 0; t < rows; t++) {
+      EXPECT_EQ(distances[b * rows + t],
+                HammingDistance::distance(queryRows[b], &train[t * bytes],
+                                          bytes));
+    }
+  }
+}
+
+TEST(hamming_distance_ut, reference) {
+  uint8_t a[3] = {0xff, 0x00, 0x0f};
+  uint8_t b[3] = {0x00, 0x00, 0xff};
+
+  EXPECT_EQ(HammingDistance::distance(a, b, 3), 12);
+}
+
+TEST(hamming_distance_ut, kernels_match_reference) {
+  const int lengths[] = {32, 64, 61};
+  HammingDistance::Isa best = HammingDistance::bestIsa();
+
+  for (int l = 0; l < 3; l++) {
+    checkKernel(lengths[l], HammingDistance::SCALAR);
+
+    if (best >= HammingDistance::AVX2) {
+      checkKernel(lengths[l], HammingDistance::AVX2);
+    }
+
+    if (best >= HammingDistance::AVX512) {
+      checkKernel(lengths[l], HammingDistance::AVX512);
+    }
+  }
+}
@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include <util/Int8Distance.hpp>
+
+static void checkKernel(int dims, Int8Distance::Isa isa) {
+  const int rows = 37;
+  const int block = Int8Distance::queryBlock;
+  vector<int8_t> queries(block * dims), train(rows * dims);
+  vector<int> distances(block * rows);
+  const int8_t *queryRows[block];
+
+  // Full range, extremes included
+  for (size_t i = 0; i < queries.size(); i++) {
+    queries[i] = (int8_t)(rand() % 256 - 128);
+  }
+
+  for (size_t i = 0; i < train.size(); i++) {
+    train[i] = (int8_t)(rand() % 256 - 128);
+  }
+
+  queries[0] = -128;
+  train[0] = 127;
+
+  for (int b = 0; b < block; b++) {
+    queryRows[b] = &queries[b * dims];
+  }
+
+  Int8Distance::select(dims, isa)(queryRows, &train[0], dims, rows, dims,
+                                  &distances[0]);
+
+  for (int b = 0; b < block; b++) {
+    for (int t = 0; t < rows; t++) {
+      EXPECT_EQ(distances[b * rows + t],
+                Int8Distance::distance(queryRows[b], &train[t * dims], dims));
+    }
+  }
+}
+
+TEST(int8_distance_ut, reference) {
+  int8_t a[3] = {-128, 0, 5};
+  int8_t b[3] = {127, 0, 2};
+
+  EXPECT_EQ(Int8Distance::distance(a, b, 3), 255 * 255 + 9);
+}
+
+TEST(int8_distance_ut, kernels) {
+  const int lengths[] = {64, 128, 40};
+
+  for (int l = 0; l < 3; l++) {
+    checkKernel(lengths[l], Int8Distance::SCALAR);
+
+    if (Int8Distance::bestIsa() >= Int8Distance::AVX2) {
+      checkKernel(lengths[l], Int8Distance::AVX2);
+    }
+  }
+}
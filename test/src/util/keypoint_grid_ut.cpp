@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <util/KeyPointGrid.hpp>
+
+TEST(keypoint_grid_ut, matches_brute_force) {
+  vector<KeyPoint> keypoints;
+  vector<int> found, expected;
+  KeyPointGrid grid(25);
+
+  // Some keypoints fall outside the image
+  for (int i = 0; i < 1000; i++) {
+    keypoints.push_back(KeyPoint(rand() % 700 - 30, rand() % 500 - 10, 1));
+  }
+
+  grid.build(keypoints, Size(640, 480));
+
+  for (int q = 0; q < 200; q++) {
+    Point2f center(rand() % 900 - 100, rand() % 700 - 100);
+    float radius = rand() % 60;
+
+    expected.clear();
+
+    for (size_t i = 0; i < keypoints.size(); i++) {
+      Point2f d = keypoints[i].pt - center;
+
+      if (d.x * d.x + d.y * d.y <= radius * radius) {
+        expected.push_back((int)i);
+      }
+    }
+
+    grid.radiusSearch(center, radius, found);
+    sort(found.begin(), found.end());
+
+    EXPECT_EQ(found, expected);
+  }
+}
+
+TEST(keypoint_grid_ut, cell_counts) {
+  vector<KeyPoint> keypoints;
+  KeyPointGrid grid(10);
+
+  keypoints.push_back(KeyPoint(5, 5, 1));
+  keypoints.push_back(KeyPoint(8, 2, 1));
+  keypoints.push_back(KeyPoint(15, 25, 1));
+  keypoints.push_back(KeyPoint(-3, 100, 1));
+
+  grid.build(keypoints, Size(20, 30));
+
+  EXPECT_EQ(grid.getCells(), Size(2, 3));
+  EXPECT_EQ(grid.count(0, 0), 2);
+  EXPECT_EQ(grid.count(1, 2), 1);
+  EXPECT_EQ(grid.count(0, 2), 1);
+  EXPECT_EQ(grid.count(1, 0), 0);
+}
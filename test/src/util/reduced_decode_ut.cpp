@@ -0,0 +1,36 @@
+#include <gtest/gtest.h>
+
+#include <opencv2/imgcodecs.hpp>
+
+#include <util/ReducedDecode.hpp>
+
+TEST(reduced_decode_ut, reduction_for) {
+  EXPECT_EQ(ReducedDecode::reductionFor(Size(5472, 3648), Size(1642, 1094)), 2);
+  EXPECT_EQ(ReducedDecode::reductionFor(Size(5472, 3648), Size(1368, 912)), 4);
+  EXPECT_EQ(ReducedDecode::reductionFor(Size(5472, 3648), Size(684, 456)), 8);
+  EXPECT_EQ(ReducedDecode::reductionFor(Size(5472, 3648), Size(100, 100)), 8);
+  EXPECT_EQ(ReducedDecode::reductionFor(Size(640, 480), Size(640, 480)), 1);
+  // Decoders round up, 401 / 2 gives 201
+  EXPECT_EQ(ReducedDecode::reductionFor(Size(401, 401), Size(201, 201)), 2);
+}
+
+TEST(reduced_decode_ut, read_scaled) {
+  string filename = "reduced_decode.jpg";
+  Mat image(480, 640, CV_8UC3), read;
+
+  randu(image, Scalar::all(0), Scalar::all(255));
+  imwrite(filename, image);
+
+  read = ReducedDecode::read(filename, Size(200, 150), image.size());
+  EXPECT_EQ(read.size(), Size(200, 150));
+  EXPECT_EQ(read.type(), CV_8UC3);
+
+  read = ReducedDecode::read(filename, Size(200, 150), image.size(),
+                             IMREAD_GRAYSCALE);
+  EXPECT_EQ(read.size(), Size(200, 150));
+  EXPECT_EQ(read.type(), CV_8UC1);
+
+  // A wrong expected size falls back to a full decode
+  read = ReducedDecode::read(filename, Size(600, 450), Size(6400, 4800));
+  EXPECT_EQ(read.size(), Size(600, 450));
+}
@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include <util/RingBuffer.hpp>
+
+TEST(ring_buffer_ut, capacity_power_of_two) {
+  RingBuffer<int> ring(100);
+
+  EXPECT_EQ(ring.capacity(), 128u);
+}
+
+TEST(ring_buffer_ut, full_and_empty) {
+  RingBuffer<int> ring(4);
+  int item = 0;
+
+  for (int i = 0; i < 4; i++) {
+    item = i;
+    EXPECT_TRUE(ring.push(item));
+  }
+
+  item = 4;
+  EXPECT_FALSE(ring.push(item));
+
+  for (int i = 0; i < 4; i++) {
+    EXPECT_TRUE(ring.pop(item));
+    EXPECT_EQ(item, i);
+  }
+
+  EXPECT_FALSE(ring.pop(item));
+}
+
+TEST(ring_buffer_ut, concurrent_producers) {
+  RingBuffer<int> ring(64);
+  vector<thread> producers;
+  vector<int> seen(4000, 0);
+  int item = 0;
+  int received = 0;
+
+  for (int p = 0; p < 4; p++) {
+    producers.push_back(thread([&ring, p] {
+      for (int i = 0; i < 1000; i++) {
+        int value = p * 1000 + i;
+
+        while (!ring.push(value)) {
+          this_thread::yield();
+        }
+      }
+    }));
+  }
+
+  while (received < 4000) {
+    if (ring.pop(item)) {
+      seen[item]++;
+      received++;
+    }
+  }
+
+  for (size_t p = 0; p < producers.size(); p++) {
+    producers[p].join();
+  }
+
+  for (int i = 0; i < 4000; i++) {
+    EXPECT_EQ(seen[i], 1);
+  }
+}
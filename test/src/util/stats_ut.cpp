@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <util/Stats.hpp>
+
+static double exactPercentile(vector<double> values, double p) {
+  size_t rank = ceil(p / 100.0 * values.size());
+
+  sort(values.begin(), values.end());
+
+  return values[max<size_t>(rank, 1) - 1];
+}
+
+TEST(stats_ut, mean_and_std_dev) {
+  Stats<double> stats("test", "s");
+
+  stats.push_back(2);
+  stats.push_back(4);
+  stats.push_back(4);
+  stats.push_back(4);
+  stats.push_back(5);
+  stats.push_back(5);
+  stats.push_back(7);
+  stats.push_back(9);
+
+  EXPECT_EQ(stats.size(), 8u);
+  EXPECT_DOUBLE_EQ(stats.mean(), 5);
+  EXPECT_DOUBLE_EQ(stats.stdDev(), 2);
+}
+
+TEST(stats_ut, percentiles) {
+  Stats<double> stats("test", "s");
+  vector<double> values;
+  double p[] = {50, 90, 99, 99.9};
+
+  for (int i = 0; i < 10000; i++) {
+    values.push_back(1e-3 * (1 + rand() % 100000));
+    stats.push_back(values.back());
+  }
+
+  for (int i = 0; i < 4; i++) {
+    EXPECT_NEAR(stats.percentile(p[i]), exactPercentile(values, p[i]),
+                0.01 * exactPercentile(values, p[i]));
+  }
+}
+
+TEST(stats_ut, merge) {
+  Stats<int> all("all", ""), first("first", ""), second("second", "");
+
+  for (int i = 0; i < 1000; i++) {
+    int value = rand() % 5000;
+
+    all.push_back(value);
+    (i % 3 ? first : second).push_back(value);
+  }
+
+  first.merge(second);
+
+  EXPECT_EQ(first.size(), all.size());
+  EXPECT_NEAR(first.mean(), all.mean(), 1e-9);
+  EXPECT_NEAR(first.stdDev(), all.stdDev(), 1e-9);
+  EXPECT_DOUBLE_EQ(first.percentile(50), all.percentile(50));
+  EXPECT_DOUBLE_EQ(first.percentile(99), all.percentile(99));
+}
+
+TEST(stats_ut, signed_values) {
+  Stats<int> stats("test", "");
+
+  stats.push_back(-100);
+  stats.push_back(0);
+  stats.push_back(100);
+
+  EXPECT_NEAR(stats.percentile(1), -100, 1);
+  EXPECT_NEAR(stats.percentile(50), 0, 1);
+  EXPECT_NEAR(stats.percentile(100), 100, 1);
+}
@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+
+#include <util/ThreadPool.hpp>
+
+TEST(thread_pool_ut, runs_all_tasks) {
+  atomic<int> counter(0);
+  ThreadPool pool(4);
+
+  for (int i = 0; i < 1000; i++) {
+    pool.push([&counter] { counter++; });
+  }
+
+  pool.wait();
+
+  EXPECT_EQ(counter, 1000);
+}
+
+TEST(thread_pool_ut, reusable_after_wait) {
+  atomic<int> counter(0);
+  ThreadPool pool(2);
+
+  for (int round = 1; round <= 3; round++) {
+    for (int i = 0; i < 10; i++) {
+      pool.push([&counter] { counter++; });
+    }
+
+    pool.wait();
+
+    EXPECT_EQ(counter, round * 10);
+  }
+}
+
+TEST(thread_pool_ut, at_least_one_worker) {
+  ThreadPool pool(0);
+
+  EXPECT_EQ(pool.size(), 1);
+}
+
+TEST(thread_pool_ut, rethrows_task_exceptions) {
+  atomic<int> counter(0);
+  ThreadPool pool(2);
+
+  pool.push([] { throw runtime_error("task failed"); });
+
+  for (int i = 0; i < 10; i++) {
+    pool.push([&counter] { counter++; });
+  }
+
+  EXPECT_THROW(pool.wait(), runtime_error);
+  EXPECT_EQ(counter, 10);
+
+  // Rethrown once, the pool keeps working
+  pool.push([&counter] { counter++; });
+  EXPECT_NO_THROW(pool.wait());
+  EXPECT_EQ(counter, 11);
+}